@@ -0,0 +1,217 @@
+#include "checkpoint.h"
+#include "stats.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace qc {
+
+namespace {
+
+constexpr char          kMagic[8]  = {'Q','C','S','T','A','T','E','\0'};
+constexpr std::uint32_t kEndianTag = 0x01020304u;
+constexpr std::size_t   kIoChunk   = 64ull << 20;   // 64 MiB per fwrite/fread
+
+struct FileCloser { void operator()(std::FILE* f) const { if (f) std::fclose(f); } };
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+[[noreturn]] void fail(const std::string& path, const char* what) {
+    throw std::runtime_error("checkpoint " + path + ": " + what);
+}
+
+// Validate a header and return its amplitude count.
+std::size_t check_header(const StateFileHeader& h, const std::string& path) {
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) fail(path, "not a state file");
+    if (h.endian_tag != kEndianTag)       fail(path, "byte order mismatch");
+    if (h.version != kStateFileVersion)   fail(path, "unsupported version");
+    if (h.precision != sizeof(double))    fail(path, "unsupported precision");
+    if (h.layout != 0)                    fail(path, "unsupported layout");
+    if (h.n_qubits >= 63 || h.n_amps != (1ull << h.n_qubits)) fail(path, "inconsistent size");
+    return static_cast<std::size_t>(h.n_amps);
+}
+
+// Reject a file too short for n_amps amplitudes. Divides rather than multiplies so a
+// hostile n_amps cannot wrap the byte count.
+void check_payload(std::size_t bytes, std::size_t n_amps, const std::string& path) {
+    if (bytes < kStateHeaderBytes || n_amps > (bytes - kStateHeaderBytes) / sizeof(C))
+        fail(path, "truncated payload");
+}
+
+// File size without ftell, whose long result is 32-bit on Windows.
+std::size_t file_bytes(const std::string& path) {
+    std::error_code ec;
+    const auto n = std::filesystem::file_size(path, ec);
+    if (ec) fail(path, "cannot read file size");
+    return static_cast<std::size_t>(n);
+}
+
+int log2_size(std::size_t n) {
+    int q = 0;
+    while ((1ull << q) < n) ++q;
+    return q;
+}
+
+} // namespace
+
+std::uint64_t state_checksum(const C* amps, std::size_t n_amps) {
+    static_assert(sizeof(C) == 2 * sizeof(std::uint64_t));
+    const auto* bytes = reinterpret_cast<const unsigned char*>(amps);
+    std::uint64_t h = 1469598103934665603ull;
+    for (std::size_t i = 0; i < 2 * n_amps; ++i) {
+        std::uint64_t w;
+        std::memcpy(&w, bytes + 8 * i, 8);
+        h = (h ^ w) * 1099511628211ull;
+    }
+    return h;
+}
+
+void save_state(const State& psi, const std::string& path) {
+    QC_STATS_SCOPE("save_state", psi.size());
+    if (psi.empty() || (psi.size() & (psi.size() - 1)) != 0) fail(path, "state size is not a power of two");
+
+    StateFileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version    = kStateFileVersion;
+    h.endian_tag = kEndianTag;
+    h.n_qubits   = static_cast<std::uint32_t>(log2_size(psi.size()));
+    h.precision  = sizeof(double);
+    h.layout     = 0;
+    h.n_amps     = psi.size();
+    h.checksum   = state_checksum(psi.data(), psi.size());
+
+    // Write next to the target and rename over it only once the data is on disk, so a crash
+    // mid-save leaves the previous checkpoint intact.
+    const std::string tmp = path + ".tmp";
+    FilePtr f(std::fopen(tmp.c_str(), "wb"));
+    if (!f) fail(path, "cannot open for writing");
+    try {
+        unsigned char head[kStateHeaderBytes] = {};
+        std::memcpy(head, &h, sizeof(h));
+        if (std::fwrite(head, 1, sizeof(head), f.get()) != sizeof(head)) fail(path, "write failed");
+
+        const auto* p = reinterpret_cast<const unsigned char*>(psi.data());
+        std::size_t left = psi.size() * sizeof(C);
+        while (left > 0) {
+            const std::size_t n = left < kIoChunk ? left : kIoChunk;
+            if (std::fwrite(p, 1, n, f.get()) != n) fail(path, "write failed");
+            p += n; left -= n;
+        }
+        if (std::fflush(f.get()) != 0) fail(path, "write failed");
+#if !defined(_WIN32)
+        if (::fsync(::fileno(f.get())) != 0) fail(path, "sync failed");
+#endif
+        if (std::fclose(f.release()) != 0) fail(path, "close failed");
+    } catch (...) {
+        f.reset();
+        std::remove(tmp.c_str());
+        throw;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::remove(tmp.c_str());
+        fail(path, "rename failed");
+    }
+}
+
+State load_state(const std::string& path, bool verify) {
+    FilePtr f(std::fopen(path.c_str(), "rb"));
+    if (!f) fail(path, "cannot open for reading");
+
+    unsigned char head[kStateHeaderBytes];
+    if (std::fread(head, 1, sizeof(head), f.get()) != sizeof(head)) fail(path, "truncated header");
+    StateFileHeader h;
+    std::memcpy(&h, head, sizeof(h));
+    const std::size_t N = check_header(h, path);
+
+    // Size the payload before allocating, so a bad header fails here and not in State(N).
+    check_payload(file_bytes(path), N, path);
+
+    QC_STATS_SCOPE("load_state", N);
+    State psi(N);
+    auto* p = reinterpret_cast<unsigned char*>(psi.data());
+    std::size_t left = N * sizeof(C);
+    while (left > 0) {
+        const std::size_t n = left < kIoChunk ? left : kIoChunk;
+        if (std::fread(p, 1, n, f.get()) != n) fail(path, "truncated payload");
+        p += n; left -= n;
+    }
+    if (verify && state_checksum(psi.data(), N) != h.checksum) fail(path, "checksum mismatch");
+    return psi;
+}
+
+MappedState::MappedState(const std::string& path, bool verify) {
+#if !defined(_WIN32)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) fail(path, "cannot open for reading");
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || (std::size_t)st.st_size < kStateHeaderBytes) {
+        ::close(fd);
+        fail(path, "truncated header");
+    }
+    bytes_ = static_cast<std::size_t>(st.st_size);
+    base_  = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base_ == MAP_FAILED) { base_ = nullptr; fail(path, "mmap failed"); }
+#else
+    // No mmap: fall back to one owned read of the whole file.
+    FilePtr f(std::fopen(path.c_str(), "rb"));
+    if (!f) fail(path, "cannot open for reading");
+    bytes_ = file_bytes(path);
+    if (bytes_ < kStateHeaderBytes) fail(path, "truncated header");
+    base_ = ::operator new(bytes_);
+    if (std::fread(base_, 1, bytes_, f.get()) != bytes_) { release(); fail(path, "read failed"); }
+#endif
+
+    StateFileHeader h;
+    std::memcpy(&h, base_, sizeof(h));
+    try {
+        n_amps_ = check_header(h, path);
+        check_payload(bytes_, n_amps_, path);
+        amps_     = reinterpret_cast<const C*>(static_cast<const unsigned char*>(base_) + kStateHeaderBytes);
+        n_qubits_ = static_cast<int>(h.n_qubits);
+        if (verify && state_checksum(amps_, n_amps_) != h.checksum) fail(path, "checksum mismatch");
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+MappedState::~MappedState() { release(); }
+
+MappedState::MappedState(MappedState&& o) noexcept
+    : base_(o.base_), bytes_(o.bytes_), amps_(o.amps_), n_amps_(o.n_amps_), n_qubits_(o.n_qubits_) {
+    o.base_ = nullptr; o.bytes_ = 0; o.amps_ = nullptr; o.n_amps_ = 0; o.n_qubits_ = 0;
+}
+
+MappedState& MappedState::operator=(MappedState&& o) noexcept {
+    if (this != &o) {
+        release();
+        base_ = o.base_; bytes_ = o.bytes_; amps_ = o.amps_; n_amps_ = o.n_amps_; n_qubits_ = o.n_qubits_;
+        o.base_ = nullptr; o.bytes_ = 0; o.amps_ = nullptr; o.n_amps_ = 0; o.n_qubits_ = 0;
+    }
+    return *this;
+}
+
+void MappedState::release() {
+    if (!base_) return;
+#if !defined(_WIN32)
+    ::munmap(base_, bytes_);
+#else
+    ::operator delete(base_);
+#endif
+    base_ = nullptr; amps_ = nullptr; bytes_ = 0; n_amps_ = 0;
+}
+
+}
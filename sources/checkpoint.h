@@ -0,0 +1,70 @@
+#pragma once
+#include "qc.h"
+
+#include <cstdint>
+#include <string>
+
+namespace qc {
+
+// On-disk state checkpoint (version 1). A fixed 4 KiB header followed by the raw amplitudes,
+// so the payload is page-aligned and can be mapped directly:
+//
+//   offset 0     StateFileHeader (zero-padded to kStateHeaderBytes)
+//   offset 4096  2^n_qubits × (re, im) as IEEE doubles, host byte order, LSB = qubit 0
+//
+// The checksum covers the amplitude bytes only. Files written on a host with a different
+// byte order are rejected via the endian tag rather than silently misread.
+struct StateFileHeader {
+    char          magic[8];     // "QCSTATE\0"
+    std::uint32_t version;      // kStateFileVersion
+    std::uint32_t endian_tag;   // 0x01020304 as written by the host
+    std::uint32_t n_qubits;
+    std::uint32_t precision;    // bytes per real component (8 = double)
+    std::uint32_t layout;       // 0 = interleaved complex, qubit 0 is the LSB of the index
+    std::uint32_t reserved;
+    std::uint64_t n_amps;
+    std::uint64_t checksum;     // state_checksum() of the payload
+};
+
+constexpr std::uint32_t kStateFileVersion = 1;
+constexpr std::size_t   kStateHeaderBytes = 4096;
+
+// 64-bit word-wise FNV-1a over the amplitude bytes.
+std::uint64_t state_checksum(const C* amps, std::size_t n_amps);
+
+// Write psi as a checkpoint (large sequential writes to path + ".tmp", then renamed over path,
+// so an interrupted save never clobbers the previous file). Throws std::runtime_error on I/O
+// failure.
+void save_state(const State& psi, const std::string& path);
+
+// Read a checkpoint into a fresh State. Throws std::runtime_error on a bad header, size
+// mismatch or (when verify is true) checksum mismatch.
+State load_state(const std::string& path, bool verify = true);
+
+// Read-only zero-copy view of a checkpoint via mmap. Many processes can share one prepared
+// state this way; call to_state() to get a private, mutable copy.
+class MappedState {
+public:
+    explicit MappedState(const std::string& path, bool verify = false);
+    ~MappedState();
+    MappedState(MappedState&& o) noexcept;
+    MappedState& operator=(MappedState&& o) noexcept;
+    MappedState(const MappedState&) = delete;
+    MappedState& operator=(const MappedState&) = delete;
+
+    const C* data() const { return amps_; }
+    std::size_t size() const { return n_amps_; }
+    int n_qubits() const { return n_qubits_; }
+    State to_state() const { return State(amps_, amps_ + n_amps_); }
+
+private:
+    void release();
+
+    void*       base_   = nullptr;   // mapping (or heap buffer where mmap is unavailable)
+    std::size_t bytes_  = 0;
+    const C*    amps_   = nullptr;
+    std::size_t n_amps_ = 0;
+    int         n_qubits_ = 0;
+};
+
+}
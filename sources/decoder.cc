@@ -0,0 +1,144 @@
+#include "decoder.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <queue>
+#include <tuple>
+
+namespace qc::surface {
+
+std::vector<int> syndrome_of(const std::vector<std::vector<int>>& checks, const ErrorBits& err) {
+    std::vector<int> syn(checks.size(), 0);
+    for (size_t k = 0; k < checks.size(); ++k)
+        for (int q : checks[k]) syn[k] ^= err[q];
+    return syn;
+}
+
+bool flips_logical(const std::vector<int>& logical, const ErrorBits& residual) {
+    int par = 0;
+    for (int q : logical) par ^= residual[q];
+    return par != 0;
+}
+
+MatchingDecoder::MatchingDecoder(int n_data, const std::vector<std::vector<int>>& checks)
+    : n_data_(n_data), n_checks_((int)checks.size())
+{
+    const int V = n_checks_ + 1;   // + boundary
+    const int B = n_checks_;
+
+    // data qubit -> checks touching it; 1 check = edge to the boundary
+    std::vector<std::vector<int>> touch(n_data);
+    for (int k = 0; k < n_checks_; ++k)
+        for (int q : checks[k]) touch[q].push_back(k);
+
+    std::vector<std::vector<std::pair<int,int>>> adj(V);   // (neighbour, data qubit)
+    for (int q = 0; q < n_data; ++q) {
+        if (touch[q].size() == 2) {
+            adj[touch[q][0]].push_back({touch[q][1], q});
+            adj[touch[q][1]].push_back({touch[q][0], q});
+        } else if (touch[q].size() == 1) {
+            adj[touch[q][0]].push_back({B, q});
+            adj[B].push_back({touch[q][0], q});
+        }
+    }
+
+    dist_.assign(V, std::vector<int>(V, INT_MAX / 4));
+    pred_node_.assign(V, std::vector<int>(V, -1));
+    pred_edge_.assign(V, std::vector<int>(V, -1));
+    for (int s = 0; s < V; ++s) {
+        std::queue<int> bfs;
+        dist_[s][s] = 0;
+        bfs.push(s);
+        while (!bfs.empty()) {
+            const int u = bfs.front(); bfs.pop();
+            for (const auto& [v, q] : adj[u]) {
+                if (dist_[s][v] <= dist_[s][u] + 1) continue;
+                dist_[s][v] = dist_[s][u] + 1;
+                pred_node_[s][v] = u;
+                pred_edge_[s][v] = q;
+                bfs.push(v);
+            }
+        }
+    }
+}
+
+void MatchingDecoder::add_path(int src, int dst, ErrorBits& corr) const {
+    for (int v = dst; v != src; v = pred_node_[src][v]) corr[pred_edge_[src][v]] ^= 1;
+}
+
+ErrorBits MatchingDecoder::decode(const std::vector<int>& syndrome) const {
+    QC_STATS_SCOPE("decode", 0);
+    ErrorBits corr(n_data_, 0);
+    std::vector<int> defects;
+    for (int k = 0; k < n_checks_; ++k) if (syndrome[k]) defects.push_back(k);
+    const int m = (int)defects.size();
+    if (m == 0) return corr;
+    const int B = boundary();
+
+    if (m <= kExactDefects) {
+        // f[mask] = min cost to resolve the defects in mask; resolve its lowest member i
+        // either against the boundary or together with one other member j.
+        const std::uint32_t full = (1u << m) - 1;
+        std::vector<int> f(full + 1, INT_MAX / 4), pick(full + 1, -1);
+        f[0] = 0;
+        for (std::uint32_t mask = 1; mask <= full; ++mask) {
+            const int i = std::countr_zero(mask);
+            const std::uint32_t rest = mask & ~(1u << i);
+            int best = dist_[defects[i]][B] + f[rest], bj = m;   // bj == m: boundary
+            for (int j = i + 1; j < m; ++j) {
+                if (!(rest & (1u << j))) continue;
+                const int c = dist_[defects[i]][defects[j]] + f[rest & ~(1u << j)];
+                if (c < best) { best = c; bj = j; }
+            }
+            f[mask] = best;
+            pick[mask] = bj;
+        }
+        for (std::uint32_t mask = full; mask; ) {
+            const int i = std::countr_zero(mask);
+            const int j = pick[mask];
+            if (j == m) { add_path(defects[i], B, corr); mask &= ~(1u << i); }
+            else        { add_path(defects[i], defects[j], corr); mask &= ~((1u << i) | (1u << j)); }
+        }
+        return corr;
+    }
+
+    // Greedy: cheapest pairs first; a boundary edge is only worth taking over a pair edge
+    // of equal cost when nothing better remains.
+    std::vector<std::tuple<int,int,int>> cand;   // (cost, i, j) with j == m for boundary
+    for (int i = 0; i < m; ++i) {
+        cand.push_back({dist_[defects[i]][B], i, m});
+        for (int j = i + 1; j < m; ++j) cand.push_back({dist_[defects[i]][defects[j]], i, j});
+    }
+    std::sort(cand.begin(), cand.end(), [m](const auto& a, const auto& b) {
+        if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) < std::get<0>(b);
+        return (std::get<2>(a) != m) > (std::get<2>(b) != m);
+    });
+    std::vector<char> used(m, 0);
+    for (const auto& [c, i, j] : cand) {
+        (void)c;
+        if (used[i] || (j != m && used[j])) continue;
+        used[i] = 1;
+        if (j == m) add_path(defects[i], B, corr);
+        else        { used[j] = 1; add_path(defects[i], defects[j], corr); }
+    }
+    return corr;
+}
+
+CodeDecoder::CodeDecoder(const SurfaceCode& sc_)
+    : sc(sc_), z_dec(sc_.n_data, sc_.z_checks), x_dec(sc_.n_data, sc_.x_checks) {}
+
+bool CodeDecoder::x_fails(const ErrorBits& x_err, const std::vector<int>& z_syn) const {
+    ErrorBits res = z_dec.decode(z_syn);
+    for (int q = 0; q < sc.n_data; ++q) res[q] ^= x_err[q];
+    return flips_logical(sc.logical_z, res);
+}
+
+bool CodeDecoder::z_fails(const ErrorBits& z_err, const std::vector<int>& x_syn) const {
+    ErrorBits res = x_dec.decode(x_syn);
+    for (int q = 0; q < sc.n_data; ++q) res[q] ^= z_err[q];
+    return flips_logical(sc.logical_x, res);
+}
+
+} // namespace qc::surface
@@ -0,0 +1,58 @@
+#pragma once
+#include "surface_code.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace qc::surface {
+
+// Per-data-qubit error bits (0/1), indexed by data qubit.
+using ErrorBits = std::vector<std::uint8_t>;
+
+// Syndrome of an error pattern against one check family: parity of err over each check.
+std::vector<int> syndrome_of(const std::vector<std::vector<int>>& checks, const ErrorBits& err);
+
+// True if the residual (error ⊕ correction) anticommutes with the given logical support.
+bool flips_logical(const std::vector<int>& logical, const ErrorBits& residual);
+
+// Minimum-weight matching decoder for one check family (code capacity: perfect syndrome,
+// independent data errors). The decoding graph has one node per check plus a single
+// boundary node; every data qubit is an edge between the (one or two) checks it touches.
+// Defects are paired with each other or with the boundary along shortest paths. Pairing is
+// exact (subset DP) up to kExactDefects defects and greedy beyond.
+class MatchingDecoder {
+public:
+    static constexpr int kExactDefects = 16;
+
+    MatchingDecoder(int n_data, const std::vector<std::vector<int>>& checks);
+
+    // Data qubits to flip (as bits) for the given syndrome, one entry per check.
+    ErrorBits decode(const std::vector<int>& syndrome) const;
+
+    int distance(int a, int b) const { return dist_[a][b]; }
+    int boundary() const { return n_checks_; }
+
+private:
+    void add_path(int src, int dst, ErrorBits& corr) const;
+
+    int n_data_;
+    int n_checks_;
+    std::vector<std::vector<int>> dist_;        // all-pairs hop counts, (n_checks+1)^2
+    std::vector<std::vector<int>> pred_node_;   // BFS tree per source: previous node
+    std::vector<std::vector<int>> pred_edge_;   // ... and the data qubit on that edge
+};
+
+// Decoders for both families of a rotated code plus the logical check (sc must outlive it).
+struct CodeDecoder {
+    explicit CodeDecoder(const SurfaceCode& sc);
+
+    // X errors are seen by Z checks (and flip Z_L); Z errors by X checks (and flip X_L).
+    bool x_fails(const ErrorBits& x_err, const std::vector<int>& z_syn) const;
+    bool z_fails(const ErrorBits& z_err, const std::vector<int>& x_syn) const;
+
+    const SurfaceCode& sc;
+    MatchingDecoder z_dec;   // decodes X errors from the Z syndrome
+    MatchingDecoder x_dec;   // decodes Z errors from the X syndrome
+};
+
+} // namespace qc::surface
@@ -0,0 +1,254 @@
+#include "dem.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <ostream>
+
+namespace qc::surface {
+
+namespace {
+
+enum class OpKind : std::uint8_t { CX, ResetZ, ResetX, MeasZ, MeasX };
+
+struct Op {
+    OpKind kind;
+    int a;      // qubit (CX: control)
+    int b;      // CX: target
+};
+
+// Pauli acting on one qubit of a fault: bit 0 = X component, bit 1 = Z component.
+constexpr int PX = 1, PZ = 2, PY = 3;
+
+// A fault is applied to the frame right before ops[at].
+struct Fault {
+    int at;
+    int qa, pa;
+    int qb, pb;     // pb == 0 for single-qubit faults
+    double p;
+};
+
+// Symptom bitset: one bit per detector plus a final bit for L0.
+using Symptom = std::vector<std::uint64_t>;
+
+struct Circuit {
+    int n_qubits = 0;
+    std::vector<Op> ops;
+    std::vector<Fault> faults;
+    int n_meas = 0;
+
+    void add(OpKind k, int a, int b = -1) { ops.push_back({k, a, b}); }
+    int measure(OpKind k, int q) { add(k, q); return n_meas++; }
+
+    void depolarize1(int at, int q, double p) {
+        if (p <= 0.0) return;
+        for (int pa : {PX, PY, PZ}) faults.push_back({at, q, pa, -1, 0, p / 3});
+    }
+    void depolarize2(int at, int q0, int q1, double p) {
+        if (p <= 0.0) return;
+        for (int pa = 0; pa < 4; ++pa)
+            for (int pb = 0; pb < 4; ++pb)
+                if (pa || pb) faults.push_back({at, q0, pa, q1, pb, p / 15});
+    }
+    void flip(int at, int q, int pauli, double p) {
+        if (p > 0.0) faults.push_back({at, q, pauli, -1, 0, p});
+    }
+};
+
+struct Layout {
+    std::vector<std::vector<int>> mz, mx;   // [round][check] measurement index
+    std::vector<int> md;                    // final data measurement index per data qubit
+};
+
+// The z_round/x_round circuit of surface_code.cc, repeated, with fault sites attached.
+Circuit build_circuit(const SurfaceCode& sc, const DemConfig& cfg, Layout& lay) {
+    Circuit c;
+    c.n_qubits = sc.n_qubits();
+    for (int r = 0; r < cfg.rounds; ++r) {
+        for (int q = 0; q < sc.n_data; ++q) c.depolarize1((int)c.ops.size(), q, cfg.p_data);
+
+        for (int a : sc.z_anc) {
+            c.add(OpKind::ResetZ, a);
+            c.flip((int)c.ops.size(), a, PX, cfg.p_reset);
+        }
+        for (const auto& layer : sc.z_layers)
+            for (const auto& [ctl, tgt] : layer) {
+                c.add(OpKind::CX, ctl, tgt);
+                c.depolarize2((int)c.ops.size(), ctl, tgt, cfg.p_cnot);
+            }
+        lay.mz.emplace_back();
+        for (int a : sc.z_anc) {
+            c.flip((int)c.ops.size(), a, PX, cfg.p_meas);
+            lay.mz.back().push_back(c.measure(OpKind::MeasZ, a));
+        }
+
+        // |+> prep and X readout; the H gates of x_round are folded into the reset/measure.
+        for (int a : sc.x_anc) {
+            c.add(OpKind::ResetX, a);
+            c.flip((int)c.ops.size(), a, PZ, cfg.p_reset);
+        }
+        for (const auto& layer : sc.x_layers)
+            for (const auto& [ctl, tgt] : layer) {
+                c.add(OpKind::CX, ctl, tgt);
+                c.depolarize2((int)c.ops.size(), ctl, tgt, cfg.p_cnot);
+            }
+        lay.mx.emplace_back();
+        for (int a : sc.x_anc) {
+            c.flip((int)c.ops.size(), a, PZ, cfg.p_meas);
+            lay.mx.back().push_back(c.measure(OpKind::MeasX, a));
+        }
+    }
+    for (int q = 0; q < sc.n_data; ++q) {
+        c.flip((int)c.ops.size(), q, cfg.x_basis ? PZ : PX, cfg.p_meas);
+        lay.md.push_back(c.measure(cfg.x_basis ? OpKind::MeasX : OpKind::MeasZ, q));
+    }
+    return c;
+}
+
+// Which detectors (and L0, as bit n_det) each measurement feeds.
+struct Detectors {
+    int n_det = 0;
+    std::vector<std::vector<int>> of_meas;
+    std::vector<std::array<double,3>> coords;
+};
+
+std::array<double,3> check_center(const std::vector<int>& check, int d, int t) {
+    double ri = 0, cj = 0;
+    for (int q : check) { ri += q / d; cj += q % d; }
+    return {ri / check.size(), cj / check.size(), (double)t};
+}
+
+Detectors build_detectors(const SurfaceCode& sc, const DemConfig& cfg, const Layout& lay,
+                          int n_meas, bool& has_obs)
+{
+    Detectors D;
+    D.of_meas.resize(n_meas);
+    auto add_det = [&](const std::vector<int>& meas, const std::array<double,3>& xyz) {
+        for (int m : meas) D.of_meas[m].push_back(D.n_det);
+        D.coords.push_back(xyz);
+        ++D.n_det;
+    };
+
+    for (int r = 0; r < cfg.rounds; ++r) {
+        for (size_t k = 0; k < sc.z_checks.size(); ++k) {
+            const auto xyz = check_center(sc.z_checks[k], sc.d, r);
+            if (r > 0)             add_det({lay.mz[r][k], lay.mz[r-1][k]}, xyz);
+            else if (!cfg.x_basis) add_det({lay.mz[r][k]}, xyz);
+        }
+        for (size_t k = 0; k < sc.x_checks.size(); ++k) {
+            const auto xyz = check_center(sc.x_checks[k], sc.d, r);
+            if (r > 0)             add_det({lay.mx[r][k], lay.mx[r-1][k]}, xyz);
+            else if (cfg.x_basis)  add_det({lay.mx[r][k]}, xyz);
+        }
+    }
+    // Final data readout rebuilds every memory-basis check; compare with the last round.
+    const auto& basis_checks = cfg.x_basis ? sc.x_checks : sc.z_checks;
+    const auto& basis_meas   = cfg.x_basis ? lay.mx : lay.mz;
+    for (size_t k = 0; k < basis_checks.size(); ++k) {
+        std::vector<int> meas{basis_meas[cfg.rounds - 1][k]};
+        for (int q : basis_checks[k]) meas.push_back(lay.md[q]);
+        add_det(meas, check_center(basis_checks[k], sc.d, cfg.rounds));
+    }
+    const auto& logical = cfg.x_basis ? sc.logical_x : sc.logical_z;
+    has_obs = !logical.empty();
+    for (int q : logical) D.of_meas[lay.md[q]].push_back(D.n_det);   // L0 sits after the detectors
+    return D;
+}
+
+// Push one X or Z on qubit q from ops[at] to the end and collect the flipped detectors.
+Symptom propagate(const Circuit& c, const Detectors& D, const std::vector<int>& meas_of_op,
+                  int at, int q, int pauli)
+{
+    std::vector<std::uint8_t> fx(c.n_qubits, 0), fz(c.n_qubits, 0);
+    fx[q] = pauli & PX;
+    fz[q] = (pauli & PZ) >> 1;
+    Symptom s((D.n_det + 1 + 63) / 64, 0);
+    for (std::size_t i = at; i < c.ops.size(); ++i) {
+        const Op& op = c.ops[i];
+        bool flipped = false;
+        switch (op.kind) {
+        case OpKind::CX:     fx[op.b] ^= fx[op.a]; fz[op.a] ^= fz[op.b]; break;
+        case OpKind::ResetZ:
+        case OpKind::ResetX: fx[op.a] = fz[op.a] = 0; break;
+        case OpKind::MeasZ:  flipped = fx[op.a]; break;
+        case OpKind::MeasX:  flipped = fz[op.a]; break;
+        }
+        if (flipped)
+            for (int det : D.of_meas[meas_of_op[i]]) s[det >> 6] ^= 1ull << (det & 63);
+    }
+    return s;
+}
+
+void xor_into(Symptom& a, const Symptom& b) {
+    for (std::size_t w = 0; w < a.size(); ++w) a[w] ^= b[w];
+}
+
+} // namespace
+
+DetectorErrorModel extract_dem(const SurfaceCode& sc, const DemConfig& cfg) {
+    assert(cfg.rounds >= 1);
+    QC_STATS_SCOPE("dem.extract", 0);
+    Layout lay;
+    const Circuit c = build_circuit(sc, cfg, lay);
+    DetectorErrorModel dem;
+    const Detectors D = build_detectors(sc, cfg, lay, c.n_meas, dem.has_observable);
+    dem.detector_coords = D.coords;
+
+    std::vector<int> meas_of_op(c.ops.size(), -1);
+    for (int i = 0, m = 0; i < (int)c.ops.size(); ++i)
+        if (c.ops[i].kind == OpKind::MeasZ || c.ops[i].kind == OpKind::MeasX) meas_of_op[i] = m++;
+
+    // Components (at, qubit, X|Z) are shared by up to 15 faults; propagate each once.
+    std::map<std::array<int,3>, Symptom> component;
+    auto effect = [&](int at, int q, int pauli) {
+        Symptom s((D.n_det + 1 + 63) / 64, 0);
+        for (int bit : {PX, PZ}) {
+            if (!(pauli & bit)) continue;
+            auto [it, fresh] = component.try_emplace({at, q, bit});
+            if (fresh) it->second = propagate(c, D, meas_of_op, at, q, bit);
+            xor_into(s, it->second);
+        }
+        return s;
+    };
+
+    std::map<Symptom, double> merged;
+    for (const Fault& f : c.faults) {
+        Symptom s = effect(f.at, f.qa, f.pa);
+        if (f.pb) xor_into(s, effect(f.at, f.qb, f.pb));
+        if (std::all_of(s.begin(), s.end(), [](std::uint64_t w) { return w == 0; })) continue;
+        double& p = merged[s];
+        p = p + f.p - 2 * p * f.p;
+    }
+
+    for (const auto& [s, p] : merged) {
+        DemError e;
+        e.p = p;
+        for (int det = 0; det < D.n_det; ++det)
+            if ((s[det >> 6] >> (det & 63)) & 1u) e.detectors.push_back(det);
+        e.observable = (s[D.n_det >> 6] >> (D.n_det & 63)) & 1u;
+        dem.errors.push_back(std::move(e));
+    }
+    std::sort(dem.errors.begin(), dem.errors.end(), [](const DemError& a, const DemError& b) {
+        return a.detectors != b.detectors ? a.detectors < b.detectors : a.observable < b.observable;
+    });
+    return dem;
+}
+
+void write_dem(std::ostream& os, const DetectorErrorModel& dem) {
+    const auto old_prec = os.precision(12);
+    for (const auto& e : dem.errors) {
+        os << "error(" << e.p << ")";
+        for (int det : e.detectors) os << " D" << det;
+        if (e.observable) os << " L0";
+        os << "\n";
+    }
+    for (std::size_t k = 0; k < dem.detector_coords.size(); ++k) {
+        const auto& xyz = dem.detector_coords[k];
+        os << "detector(" << xyz[0] << ", " << xyz[1] << ", " << xyz[2] << ") D" << k << "\n";
+    }
+    if (dem.has_observable) os << "logical_observable L0\n";
+    os.precision(old_prec);
+}
+
+} // namespace qc::surface
@@ -0,0 +1,48 @@
+#pragma once
+#include "surface_code.h"
+
+#include <array>
+#include <iosfwd>
+#include <vector>
+
+namespace qc::surface {
+
+// Detector error model of a memory experiment on a SurfaceCode patch: `rounds` rounds of
+// z_round + x_round on one register (same resets, CNOT layers and measurements as
+// surface_code.cc), then every data qubit measured in the memory basis.
+//
+// Detectors compare each check with the same check one round earlier; checks of the memory
+// basis are also compared with |0>/|+> in round 0 and with the final data measurement.
+// Observable L0 is the final value of the memory-basis logical (rotated layout only).
+struct DemConfig {
+    int rounds = 3;
+    bool x_basis = false;      // false: |0>, Z checks, Z_L;  true: |+>, X checks, X_L
+    double p_data  = 0.0;      // depolarizing on every data qubit at the start of each round
+    double p_cnot  = 0.0;      // two-qubit depolarizing after every CNOT
+    double p_meas  = 0.0;      // flip of every measurement (ancillas and final data)
+    double p_reset = 0.0;      // flip right after every ancilla reset
+};
+
+struct DemError {
+    double p = 0.0;
+    std::vector<int> detectors;    // ascending
+    bool observable = false;       // flips L0
+};
+
+struct DetectorErrorModel {
+    std::vector<std::array<double,3>> detector_coords;  // (row, col, round) of each detector
+    bool has_observable = false;
+    // One entry per distinct symptom: faults with identical detectors/observable are merged
+    // (p = p1 + p2 - 2 p1 p2); faults that flip nothing are dropped.
+    std::vector<DemError> errors;
+};
+
+// Every single-Pauli fault is pushed through the Clifford circuit as a Pauli frame, so the
+// cost is O(faults × circuit length) bit operations, no state vector. Two-qubit faults are
+// XORs of the four single-qubit X/Z components, each propagated once.
+DetectorErrorModel extract_dem(const SurfaceCode& sc, const DemConfig& cfg);
+
+// Stim-style text: "error(p) D.. L0" lines, then "detector(r, c, t) Dk" lines.
+void write_dem(std::ostream& os, const DetectorErrorModel& dem);
+
+} // namespace qc::surface
@@ -0,0 +1,175 @@
+#include "density.h"
+#include "stats.h"
+
+#include <random>
+
+namespace qc {
+
+namespace {
+
+double urand01() {
+    thread_local std::mt19937_64 eng(std::random_device{}());
+    thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return dist(eng);
+}
+
+// Zero every element whose (row, col) bits on target are not kept by keep(r, c).
+template <class Keep>
+void mask_blocks(DensityMatrix& rho, int target, Keep keep) {
+    const std::size_t cbit = 1ull << target;
+    const std::size_t rbit = cbit << rho.n;
+    for (std::size_t i = 0; i < rho.rho.size(); ++i)
+        if (!keep((i & rbit) != 0, (i & cbit) != 0)) rho.rho[i] = C{0,0};
+}
+
+// Spread k's bits at and above pos up by one, leaving a zero at pos.
+inline std::size_t insert_zero(std::size_t k, int pos) {
+    const std::size_t low = k & ((1ull << pos) - 1);
+    return ((k >> pos) << (pos + 1)) | low;
+}
+
+} // namespace
+
+DensityMatrix density_basis(int n_qubits, std::uint64_t index) {
+    DensityMatrix d;
+    d.n = n_qubits;
+    d.rho.assign(1ull << (2 * n_qubits), C{0,0});
+    if (index < (1ull << n_qubits)) d.rho[(index << n_qubits) | index] = C{1,0};
+    return d;
+}
+
+DensityMatrix density_from_state(const State& psi) {
+    int n = 0;
+    while ((1ull << n) < psi.size()) ++n;
+    DensityMatrix d;
+    d.n = n;
+    d.rho.resize(psi.size() * psi.size());
+    for (std::size_t r = 0; r < psi.size(); ++r)
+        for (std::size_t c = 0; c < psi.size(); ++c)
+            d.rho[(r << n) | c] = psi[r] * std::conj(psi[c]);
+    return d;
+}
+
+double trace(const DensityMatrix& rho) {
+    double t = 0.0;
+    const std::size_t N = 1ull << rho.n;
+    for (std::size_t i = 0; i < N; ++i) t += rho.rho[(i << rho.n) | i].real();
+    return t;
+}
+
+std::vector<double> diagonal(const DensityMatrix& rho) {
+    const std::size_t N = 1ull << rho.n;
+    std::vector<double> p(N);
+    for (std::size_t i = 0; i < N; ++i) p[i] = rho.rho[(i << rho.n) | i].real();
+    return p;
+}
+
+void apply_superop_1q(const C S[4][4], DensityMatrix& rho, int target) {
+    // (row bit, col bit) = (high, low) of the pair, which is apply_2q's 00,01,10,11 order.
+    apply_2q(S, rho.rho, target, target + rho.n);
+}
+
+void apply_1q(const C U[2][2], DensityMatrix& rho, int target) {
+    QC_STATS_SCOPE("dm.apply_1q", rho.rho.size());
+    C S[4][4];
+    for (int r = 0; r < 2; ++r) for (int c = 0; c < 2; ++c)
+        for (int a = 0; a < 2; ++a) for (int b = 0; b < 2; ++b)
+            S[2*r + c][2*a + b] = U[r][a] * std::conj(U[c][b]);
+    apply_superop_1q(S, rho, target);
+}
+
+void apply_2q(const C U4[4][4], DensityMatrix& rho, int qA, int qB) {
+    QC_STATS_SCOPE("dm.apply_2q", rho.rho.size());
+    C Uc[4][4];
+    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) Uc[r][c] = std::conj(U4[r][c]);
+    apply_2q(U4, rho.rho, qA + rho.n, qB + rho.n);   // rows:    U
+    apply_2q(Uc, rho.rho, qA, qB);                   // columns: conj(U)  (ρU† = (conj(U) ρᵀ)ᵀ)
+}
+
+void apply_controlled_1q(const C U[2][2], DensityMatrix& rho, int control, int target) {
+    C U4[4][4] = {};
+    // Same layout as qc.cc's make_controlled_U: U acts where the control bit is 1.
+    if (control > target) {
+        U4[0][0] = U4[1][1] = C{1,0};
+        U4[2][2] = U[0][0]; U4[2][3] = U[0][1];
+        U4[3][2] = U[1][0]; U4[3][3] = U[1][1];
+    } else {
+        U4[0][0] = U4[2][2] = C{1,0};
+        U4[1][1] = U[0][0]; U4[1][3] = U[0][1];
+        U4[3][1] = U[1][0]; U4[3][3] = U[1][1];
+    }
+    apply_2q(U4, rho, control, target);
+}
+
+void apply_cnot_layer(DensityMatrix& rho, const std::vector<std::pair<int,int>>& cnots) {
+    // CNOT is real, so rows and columns get the same permutation; do both in one sweep.
+    std::vector<std::pair<int,int>> both(cnots);
+    for (const auto& [c, t] : cnots) both.push_back({c + rho.n, t + rho.n});
+    apply_cnot_layer(rho.rho, both);
+}
+
+void apply_kraus_1q(const std::vector<Kraus1q>& kraus, DensityMatrix& rho, int target) {
+    QC_STATS_SCOPE("dm.kraus", rho.rho.size());
+    C S[4][4] = {};
+    for (const auto& K : kraus)
+        for (int r = 0; r < 2; ++r) for (int c = 0; c < 2; ++c)
+            for (int a = 0; a < 2; ++a) for (int b = 0; b < 2; ++b)
+                S[2*r + c][2*a + b] += K[r][a] * std::conj(K[c][b]);
+    apply_superop_1q(S, rho, target);
+}
+
+void apply_pauli_channel(DensityMatrix& rho, int target, double px, double py, double pz) {
+    QC_STATS_SCOPE("dm.pauli_channel", rho.rho.size());
+    // Σ p_P PρP in closed form: each diagonal entry of the (row, col) block mixes with its
+    // flip, each coherence with the other one, all with real weights. Two real 2×2 mixes
+    // per block instead of a general 4×4 complex superoperator.
+    const double p0 = 1.0 - px - py - pz;
+    const double dk = p0 + pz, df = px + py;   // 00 <-> 11
+    const double ok = p0 - pz, of = px - py;   // 01 <-> 10
+    const std::size_t cbit = 1ull << target;
+    const std::size_t rbit = cbit << rho.n;
+    const std::size_t blocks = rho.rho.size() >> 2;
+    C* a = rho.rho.data();
+    for (std::size_t k = 0; k < blocks; ++k) {
+        std::size_t i = insert_zero(k, target);
+        i = insert_zero(i, target + rho.n);
+        const C a00 = a[i], a01 = a[i | cbit], a10 = a[i | rbit], a11 = a[i | cbit | rbit];
+        a[i]               = dk * a00 + df * a11;
+        a[i | cbit | rbit] = dk * a11 + df * a00;
+        a[i | cbit]        = ok * a01 + of * a10;
+        a[i | rbit]        = ok * a10 + of * a01;
+    }
+}
+
+double prob_zero(const DensityMatrix& rho, int target) {
+    double p0 = 0.0;
+    const std::size_t N = 1ull << rho.n;
+    for (std::size_t i = 0; i < N; ++i)
+        if (!((i >> target) & 1ull)) p0 += rho.rho[(i << rho.n) | i].real();
+    return p0;
+}
+
+double project_qubit_Z(DensityMatrix& rho, int target, int outcome) {
+    QC_STATS_SCOPE("dm.project", rho.rho.size());
+    const double p0 = prob_zero(rho, target);
+    const double tr = trace(rho);
+    const double p  = outcome == 0 ? p0 : tr - p0;
+    mask_blocks(rho, target, [outcome](bool r, bool c) { return r == (outcome != 0) && c == (outcome != 0); });
+    if (p > 0.0) for (auto& a : rho.rho) a /= p;
+    return tr > 0.0 ? p / tr : 0.0;
+}
+
+void dephase_qubit_Z(DensityMatrix& rho, int target) {
+    QC_STATS_SCOPE("dm.dephase", rho.rho.size());
+    mask_blocks(rho, target, [](bool r, bool c) { return r == c; });
+}
+
+int measure_qubit_Z(DensityMatrix& rho, int target) {
+    const double tr = trace(rho);
+    const double p0 = tr > 0.0 ? prob_zero(rho, target) / tr : 1.0;
+    const int outcome = urand01() < p0 ? 0 : 1;
+    project_qubit_Z(rho, target, outcome);
+    return outcome;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "qc.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace qc {
+
+// Density matrix of n qubits stored as vec(ρ): element ρ[r][c] sits at index (r << n) | c,
+// i.e. a 2n-qubit "state" whose low n bits are the column (bra) and high n bits the row
+// (ket). A 1-qubit map on qubit t is then a 4×4 superoperator on the bit pair (t, t+n), so
+// every gate, channel and measurement below is one pass of the state-vector kernels.
+// Memory is 16·4^n bytes: 11 qubits = 64 MiB, 13 qubits = 1 GiB.
+struct DensityMatrix {
+    int n = 0;
+    State rho;
+};
+
+using Kraus1q = std::array<std::array<C,2>,2>;
+
+DensityMatrix density_basis(int n_qubits, std::uint64_t index);
+DensityMatrix density_from_state(const State& psi);
+double trace(const DensityMatrix& rho);
+// Diagonal ρ[i][i] (probability of basis state i).
+std::vector<double> diagonal(const DensityMatrix& rho);
+
+// ρ → U ρ U†
+void apply_1q(const C U[2][2], DensityMatrix& rho, int target);
+void apply_2q(const C U4[4][4], DensityMatrix& rho, int qA, int qB);
+void apply_controlled_1q(const C U[2][2], DensityMatrix& rho, int control, int target);
+// Layer of commuting CNOTs (see qc.h); permutes rows and columns in one sweep.
+void apply_cnot_layer(DensityMatrix& rho, const std::vector<std::pair<int,int>>& cnots);
+
+// ρ → S(ρ) for a 1-qubit superoperator S[(r,c)][(a,b)], indices ordered 00,01,10,11.
+void apply_superop_1q(const C S[4][4], DensityMatrix& rho, int target);
+// ρ → Σ_k K ρ K†
+void apply_kraus_1q(const std::vector<Kraus1q>& kraus, DensityMatrix& rho, int target);
+// ρ → (1-px-py-pz) ρ + px XρX + py YρY + pz ZρZ
+void apply_pauli_channel(DensityMatrix& rho, int target, double px, double py, double pz);
+inline void apply_depolarizing(DensityMatrix& rho, int target, double p) {
+    apply_pauli_channel(rho, target, p / 3, p / 3, p / 3);
+}
+
+// Probability of reading 0 on target.
+double prob_zero(const DensityMatrix& rho, int target);
+// Post-selected projector onto |outcome>; returns its probability and renormalizes (unless 0).
+double project_qubit_Z(DensityMatrix& rho, int target, int outcome);
+// Non-selective Z measurement: ρ → P0 ρ P0 + P1 ρ P1 (off-diagonal blocks dropped).
+void dephase_qubit_Z(DensityMatrix& rho, int target);
+// Sampled measurement: draws the outcome, collapses and renormalizes.
+int measure_qubit_Z(DensityMatrix& rho, int target);
+
+}
@@ -0,0 +1,155 @@
+#include "enumerate.h"
+#include "decoder.h"
+#include "parallel.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+namespace qc::surface {
+
+namespace {
+
+// binom[n][k] for k <= kmax; the ranges used here stay far below 2^64.
+std::vector<std::vector<std::uint64_t>> binomials(int n, int kmax) {
+    std::vector<std::vector<std::uint64_t>> b(n + 1, std::vector<std::uint64_t>(kmax + 1, 0));
+    for (int i = 0; i <= n; ++i) {
+        b[i][0] = 1;
+        for (int k = 1; k <= std::min(i, kmax); ++k) b[i][k] = b[i-1][k-1] + (k <= i - 1 ? b[i-1][k] : 0);
+    }
+    return b;
+}
+
+// Combinatorial number system: rank = Σ_i C(c_i, i+1) with c_0 < c_1 < ... < c_{k-1}.
+void unrank(std::uint64_t rank, int k, int n, const std::vector<std::vector<std::uint64_t>>& b,
+            std::vector<int>& c)
+{
+    c.assign(k, 0);
+    int top = n - 1;
+    for (int i = k; i >= 1; --i) {
+        while (b[top][i] > rank) --top;
+        c[i-1] = top;
+        rank -= b[top][i];
+        --top;
+    }
+}
+
+} // namespace
+
+std::vector<int> unrank_subset(std::uint64_t rank, int k, int n) {
+    std::vector<int> c;
+    unrank(rank, k, n, binomials(n, k), c);
+    return c;
+}
+
+void next_subset_colex(std::vector<int>& c) {
+    const int k = (int)c.size();
+    int j = 0;
+    while (j + 1 < k && c[j] + 1 == c[j+1]) ++j;
+    ++c[j];
+    for (int l = 0; l < j; ++l) c[l] = l;
+}
+
+namespace {
+
+struct Counts { std::uint64_t fail = 0, x = 0, z = 0; };
+
+// All 3^k Paulis supported exactly on S: X part A and Z part B with A ∪ B = S.
+Counts count_subset(const CodeDecoder& dec, const SurfaceCode& sc, const std::vector<int>& S,
+                    std::vector<std::uint8_t>& fx, std::vector<std::uint8_t>& fz, ErrorBits& err)
+{
+    const int k = (int)S.size();
+    const std::uint32_t full = (1u << k) - 1;
+    fx.assign(full + 1, 0);
+    fz.assign(full + 1, 0);
+    for (std::uint32_t m = 0; m <= full; ++m) {
+        std::fill(err.begin(), err.end(), 0);
+        for (int i = 0; i < k; ++i) if (m >> i & 1u) err[S[i]] = 1;
+        fx[m] = dec.x_fails(err, syndrome_of(sc.z_checks, err));
+        fz[m] = dec.z_fails(err, syndrome_of(sc.x_checks, err));
+    }
+    Counts c;
+    for (std::uint32_t a = 0; a <= full; ++a) {
+        // B = (S \ A) ∪ C for every C ⊆ A
+        const std::uint32_t base = full & ~a;
+        for (std::uint32_t sub = a;; sub = (sub - 1) & a) {
+            const std::uint32_t b = base | sub;
+            c.x += fx[a];
+            c.z += fz[b];
+            c.fail += (fx[a] | fz[b]);
+            if (sub == 0) break;
+        }
+    }
+    return c;
+}
+
+} // namespace
+
+EnumerationResult enumerate_low_weight(int d, int max_weight) {
+    const auto sc = build_rotated_surface_code(d);
+    const CodeDecoder dec(sc);
+    const int n = sc.n_data;
+    assert(max_weight >= 0 && max_weight <= n && max_weight < 32);
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto b = binomials(n, max_weight);
+
+    EnumerationResult r;
+    r.d = d;
+    r.n_data = n;
+    r.max_weight = max_weight;
+    r.errors.assign(max_weight + 1, 0);
+    r.failures.assign(max_weight + 1, 0);
+    r.x_failures.assign(max_weight + 1, 0);
+    r.z_failures.assign(max_weight + 1, 0);
+
+    for (int k = 0; k <= max_weight; ++k) {
+        const std::uint64_t subsets = b[n][k];
+        std::uint64_t pow3 = 1;
+        for (int i = 0; i < k; ++i) pow3 *= 3;
+        r.errors[k] = subsets * pow3;
+        // No state vector here: the "amplitudes" of this scope are the error patterns decoded.
+        QC_STATS_SCOPE("surface.enumerate", r.errors[k]);
+
+        constexpr std::size_t kMinSubsets = 64;
+        std::vector<Counts> per_worker(parallel_workers(subsets, kMinSubsets));
+        parallel_for(subsets, kMinSubsets, [&](std::size_t begin, std::size_t end, unsigned w) {
+            std::vector<int> S;
+            std::vector<std::uint8_t> fx, fz;
+            ErrorBits err(n, 0);
+            unrank(begin, k, n, b, S);
+            Counts acc;
+            for (std::size_t rank = begin; rank < end; ++rank) {
+                const Counts c = count_subset(dec, sc, S, fx, fz, err);
+                acc.fail += c.fail; acc.x += c.x; acc.z += c.z;
+                if (k > 0 && rank + 1 < end) next_subset_colex(S);
+            }
+            per_worker[w] = acc;
+        });
+        for (const auto& c : per_worker) {
+            r.failures[k] += c.fail;
+            r.x_failures[k] += c.x;
+            r.z_failures[k] += c.z;
+        }
+    }
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+double failure_polynomial(const EnumerationResult& r, double p) {
+    double s = 0.0;
+    for (int k = 0; k <= r.max_weight; ++k)
+        s += (double)r.failures[k] * std::pow(p / 3, k) * std::pow(1 - p, r.n_data - k);
+    return s;
+}
+
+double truncation_bound(const EnumerationResult& r, double p) {
+    // 1 - P(weight <= w); P(weight <= w) = Σ C(n,k) p^k (1-p)^(n-k) = Σ errors[k] (p/3)^k (1-p)^(n-k)
+    double head = 0.0;
+    for (int k = 0; k <= r.max_weight; ++k)
+        head += (double)r.errors[k] * std::pow(p / 3, k) * std::pow(1 - p, r.n_data - k);
+    return std::max(0.0, 1.0 - head);
+}
+
+} // namespace qc::surface
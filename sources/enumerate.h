@@ -0,0 +1,43 @@
+#pragma once
+#include "surface_code.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace qc::surface {
+
+// Exhaustive code-capacity enumeration on a rotated patch: every data-qubit Pauli error of
+// weight k <= max_weight is decoded with CodeDecoder, giving exact failure counts A_k. With
+// depolarizing p each weight-k Pauli has probability (p/3)^k (1-p)^(n-k), so
+//
+//   P_L(p) = Σ_k A_k (p/3)^k (1-p)^(n-k)
+//
+// exactly up to the truncation, whose size is bounded by P(weight > max_weight).
+struct EnumerationResult {
+    int d = 0;
+    int n_data = 0;
+    int max_weight = 0;
+    std::vector<std::uint64_t> errors;       // [k] = C(n,k) 3^k
+    std::vector<std::uint64_t> failures;     // [k] = A_k, X_L or Z_L flipped after decoding
+    std::vector<std::uint64_t> x_failures;   // [k] Z_L flipped (X part misdecoded)
+    std::vector<std::uint64_t> z_failures;   // [k] X_L flipped (Z part misdecoded)
+    double seconds = 0.0;
+};
+
+// Subsets of each weight are ranked in the combinatorial number system; parallel_for splits
+// the rank range into chunks and each chunk unranks its first subset, then steps in colex
+// order. Within a subset S only the X part (⊆ S) and Z part (⊆ S) are decoded, 2·2^|S|
+// decodes, and the 3^|S| Pauli assignments are counted from those tables.
+EnumerationResult enumerate_low_weight(int d, int max_weight);
+
+// k-subset of {0..n-1} with the given rank in colex order (combinatorial number system:
+// rank = Σ_i C(c_i, i+1) for ascending c), and the step to the subset of rank + 1.
+std::vector<int> unrank_subset(std::uint64_t rank, int k, int n);
+void next_subset_colex(std::vector<int>& c);
+
+// Σ_{k<=w} A_k (p/3)^k (1-p)^(n-k)
+double failure_polynomial(const EnumerationResult& r, double p);
+// P(weight > w) = Σ_{k>w} C(n,k) p^k (1-p)^(n-k): the most the unenumerated tail can add.
+double truncation_bound(const EnumerationResult& r, double p);
+
+} // namespace qc::surface
@@ -1,7 +1,25 @@
 #include "qc.h"
+#include "stats.h"
 
-int main()
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv)
 {
+    bool show_stats = false;
+    const char* trace_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stats") == 0) {
+            show_stats = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--stats] [--trace <file>]\n";
+            return 1;
+        }
+    }
+    if (show_stats) qc::stats::set_enabled(true);
+    if (trace_path) qc::stats::set_tracing(true);
 
     int n = 3;
     qc::State psi = qc::basis(n, 0); // |000>
@@ -23,5 +41,10 @@ int main()
 
     qc::pretty_print(psi, n, /*max_terms=*/8, /*cutoff=*/1e-9,
                  /*precision=*/6, /*show_prob=*/true, /*show_phase=*/true);
-    
+
+    if (show_stats) qc::stats::print_summary(std::cerr);
+    if (trace_path && !qc::stats::write_chrome_trace(trace_path)) {
+        std::cerr << "Error: cannot write trace to " << trace_path << "\n";
+        return 1;
+    }
 }
@@ -0,0 +1,131 @@
+// sources/main_dem.cc
+#include "dem.h"
+#include "stats.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace qc;
+using namespace qc::surface;
+
+namespace {
+
+bool parse_next_int(int argc, char** argv, int& i, int& out) {
+    if (i + 1 >= argc) return false;
+    char* endp = nullptr;
+    long v = std::strtol(argv[i + 1], &endp, 10);
+    if (endp == argv[i + 1] || *endp != '\0') return false;
+    out = static_cast<int>(v);
+    i += 1;
+    return true;
+}
+bool parse_next_prob(int argc, char** argv, int& i, double& out) {
+    if (i + 1 >= argc) return false;
+    char* endp = nullptr;
+    double v = std::strtod(argv[i + 1], &endp);
+    if (endp == argv[i + 1] || *endp != '\0' || v < 0.0 || v > 1.0) return false;
+    out = v;
+    i += 1;
+    return true;
+}
+void usage(const char* prog) {
+    std::cerr <<
+        "Usage: " << prog << " [options]\n"
+        "Write the detector error model of a surface-code memory experiment.\n"
+        "  --d <odd>        code distance (odd >= 3). Default: 3\n"
+        "  --rotated        rotated layout (has a logical; otherwise no L0 is emitted).\n"
+        "  --rounds <N>     syndrome rounds before the final data readout (default: 3).\n"
+        "  --basis <Z|X>    memory basis (default: Z).\n"
+        "  --p <p>          set all four fault probabilities below.\n"
+        "  --p-data <p>     depolarizing on each data qubit at the start of every round.\n"
+        "  --p-cnot <p>     two-qubit depolarizing after every CNOT.\n"
+        "  --p-meas <p>     measurement flip (ancillas and final data).\n"
+        "  --p-reset <p>    flip after every ancilla reset.\n"
+        "  --out <file>     output file (default: stdout).\n"
+        "  --stats          print per-kernel calls/time to stderr at exit.\n"
+        "  --help           show this help.\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int d = 3;
+    bool rotated = false;
+    bool show_stats = false;
+    const char* out_path = nullptr;
+    DemConfig cfg;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else if (std::strcmp(argv[i], "--d") == 0) {
+            if (!parse_next_int(argc, argv, i, d) || d < 3 || (d % 2) == 0) {
+                std::cerr << "Error: --d must be odd integer >= 3\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--rotated") == 0) {
+            rotated = true;
+        } else if (std::strcmp(argv[i], "--rounds") == 0) {
+            if (!parse_next_int(argc, argv, i, cfg.rounds) || cfg.rounds <= 0) {
+                std::cerr << "Error: --rounds must be positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--basis") == 0) {
+            if (i + 1 >= argc || (std::strcmp(argv[i + 1], "Z") != 0 && std::strcmp(argv[i + 1], "X") != 0)) {
+                std::cerr << "Error: --basis must be Z or X\n";
+                return 1;
+            }
+            cfg.x_basis = argv[++i][0] == 'X';
+        } else if (std::strcmp(argv[i], "--p") == 0) {
+            double p;
+            if (!parse_next_prob(argc, argv, i, p)) { std::cerr << "Error: --p must be in [0,1]\n"; return 1; }
+            cfg.p_data = cfg.p_cnot = cfg.p_meas = cfg.p_reset = p;
+        } else if (std::strcmp(argv[i], "--p-data") == 0) {
+            if (!parse_next_prob(argc, argv, i, cfg.p_data)) { std::cerr << "Error: --p-data must be in [0,1]\n"; return 1; }
+        } else if (std::strcmp(argv[i], "--p-cnot") == 0) {
+            if (!parse_next_prob(argc, argv, i, cfg.p_cnot)) { std::cerr << "Error: --p-cnot must be in [0,1]\n"; return 1; }
+        } else if (std::strcmp(argv[i], "--p-meas") == 0) {
+            if (!parse_next_prob(argc, argv, i, cfg.p_meas)) { std::cerr << "Error: --p-meas must be in [0,1]\n"; return 1; }
+        } else if (std::strcmp(argv[i], "--p-reset") == 0) {
+            if (!parse_next_prob(argc, argv, i, cfg.p_reset)) { std::cerr << "Error: --p-reset must be in [0,1]\n"; return 1; }
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            if (i + 1 >= argc) { usage(argv[0]); return 1; }
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            show_stats = true;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (show_stats) stats::set_enabled(true);
+
+    const auto sc = rotated ? build_rotated_surface_code(d) : build_surface_code(d);
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto dem = extract_dem(sc, cfg);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ofstream ofs;
+    if (out_path) {
+        ofs.open(out_path);
+        if (!ofs) {
+            std::cerr << "Error: cannot write " << out_path << "\n";
+            return 1;
+        }
+    }
+    std::ostream& os = out_path ? ofs : std::cout;
+    os << "# qc_dem d=" << d << (rotated ? " rotated" : " bulk") << " rounds=" << cfg.rounds
+       << " basis=" << (cfg.x_basis ? 'X' : 'Z') << " p_data=" << cfg.p_data << " p_cnot=" << cfg.p_cnot
+       << " p_meas=" << cfg.p_meas << " p_reset=" << cfg.p_reset << "\n";
+    write_dem(os, dem);
+
+    std::cerr << "detectors=" << dem.detector_coords.size() << " errors=" << dem.errors.size()
+              << " elapsed=" << ms << "ms\n";
+    if (show_stats) stats::print_summary(std::cerr);
+    return 0;
+}
@@ -1,12 +1,18 @@
 // sources/main_surface.cc
 #include "qc.h"
 #include "surface_code.h"
+#include "stats.h"
+#include "surface_pipeline.h"
+#include "sweep.h"
+#include "surface_exact.h"
+#include "enumerate.h"
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 #include <random>
 #include <cstring>
 #include <cstdlib>
-#include <numbers>
 
 using namespace qc;
 using namespace qc::surface;
@@ -32,71 +38,99 @@ bool parse_next_double(int argc, char** argv, int& i, double& out) {
     i += 1;
     return true;
 }
+// Comma-separated lists, e.g. "3,5,7" or "0.01,0.02".
+bool parse_next_int_list(int argc, char** argv, int& i, std::vector<int>& out) {
+    if (i + 1 >= argc) return false;
+    out.clear();
+    const char* p = argv[i + 1];
+    while (*p) {
+        char* endp = nullptr;
+        long v = std::strtol(p, &endp, 10);
+        if (endp == p || (*endp != ',' && *endp != '\0')) return false;
+        out.push_back(static_cast<int>(v));
+        p = (*endp == ',') ? endp + 1 : endp;
+    }
+    i += 1;
+    return !out.empty();
+}
+bool parse_next_double_list(int argc, char** argv, int& i, std::vector<double>& out) {
+    if (i + 1 >= argc) return false;
+    out.clear();
+    const char* p = argv[i + 1];
+    while (*p) {
+        char* endp = nullptr;
+        double v = std::strtod(p, &endp);
+        if (endp == p || (*endp != ',' && *endp != '\0')) return false;
+        out.push_back(v);
+        p = (*endp == ',') ? endp + 1 : endp;
+    }
+    i += 1;
+    return !out.empty();
+}
 void usage(const char* prog) {
     std::cerr <<
         "Usage: " << prog << " [options]\n"
         "  --d <odd>      surfcae-code distance (odd >= 3). Default: 3\n"
-        "  --x <i>        inject X on data qubit i (0..8). Can repeat.\n"
-        "  --z <i>        inject Z on data qubit i (0..8). Can repeat.\n"
-        "  --y <i>        inject Y on data qubit i (0..8). Can repeat.\n"
+        "  --rotated      rotated layout with weight-2 boundary checks (2d^2-1 qubits).\n"
+        "  --x <i>        inject X on data qubit i (0..d*d-1). Can repeat.\n"
+        "  --z <i>        inject Z on data qubit i (0..d*d-1). Can repeat.\n"
+        "  --y <i>        inject Y on data qubit i (0..d*d-1). Can repeat.\n"
         "  --rounds <N>   run N rounds (default: 1).\n"
         "  --noise-p <p>  depolarizing per data qubit with prob p (X/Y/Z equally).\n"
         "  --seed <u64>   RNG seed (default: random_device).\n"
+        "  --shots <N>    decoding mode (needs --rotated): simulate N shots, decode them and\n"
+        "                 count logical failures in a simulate->decode->aggregate pipeline.\n"
+        "  --sim-threads <k>     simulator workers in decoding mode (default: 1).\n"
+        "  --decode-threads <k>  decoder workers in decoding mode (default: 1).\n"
+        "  --batch <k>    shots per pipeline batch (default: 64; 256 in a sweep).\n"
+        "  --exact        exact syndrome distributions (and logical failure probabilities with\n"
+        "                 --rotated) from the density matrix instead of sampling (d=3 only).\n"
+        "  --enumerate <w>  decode every data Pauli of weight <= w (needs --rotated) and print the\n"
+        "                 exact failure counts A_k and P_L(p) = sum_k A_k (p/3)^k (1-p)^(n-k).\n"
+        "  --sweep-d <d1,d2,..>  threshold sweep over distances (rotated layout) ...\n"
+        "  --sweep-p <p1,p2,..>  ... and physical error rates; every (d,p) point runs in parallel.\n"
+        "                 --shots is the per-point cap (default: 1000000).\n"
+        "  --target-failures <k> stop a point after k logical failures (default: 100, 0 = off).\n"
+        "  --target-ci <r>       stop a point once the 95% Wilson half-width <= r * p_L (0 = off).\n"
+        "  --sweep-threads <k>   points run concurrently (default: hardware threads).\n"
+        "  --out <file>   sweep results as CSV, or JSON if the name ends in .json (default: stdout CSV).\n"
+        "  --stats        print per-kernel calls/amplitudes/time to stderr at exit.\n"
+        "  --trace <file> write a Chrome trace (chrome://tracing) of every kernel call.\n"
         "  --help         show this help.\n";
 }
 inline void check_data_range(int q, int d) {
     const int n_data = d * d;
-    if (q < 0 || q > n_data) {
+    if (q < 0 || q >= n_data) {
         std::cerr << "Error: data qubit index must be in 0.." << (n_data - 1) << " (got " << q << ")\n";
         std::exit(2);
     }
 }
 
 // ---------- noise injection ----------
-struct PauliGates {
-    C Xg[2][2];
-    C Zg[2][2];
-    PauliGates() {
-        gate_X(Xg);
-        gate_Rz(Zg, std::numbers::pi); // Z (global phase ignored)
-    }
-};
-
-inline void apply_pauli(int kind /*0:X,1:Z,2:Y*/, State& psi, int q, const PauliGates& G) {
-    switch (kind) {
-    case 0: apply_1q(G.Xg, psi, q); break; // X
-    case 1: apply_1q(G.Zg, psi, q); break; // Z
-    case 2: apply_1q(G.Xg, psi, q); apply_1q(G.Zg, psi, q); break; // Y = i XZ
-    }
+// Errors are collected into X/Z masks and applied with one apply_pauli_string sweep,
+// however many qubits were hit.
+inline void add_pauli(int kind /*0:X,1:Z,2:Y*/, int q, std::uint64_t& xm, std::uint64_t& zm) {
+    const std::uint64_t bit = 1ull << q;
+    if (kind != 1) xm ^= bit; // X or Y
+    if (kind != 0) zm ^= bit; // Z or Y
 }
 
-// Apply fixed Pauli injections and depolarizing noise
-void inject_fixed_and_noise(State& psi,
-                            const SurfaceCode &sc,
-                            const std::vector<int>& xs,
-                            const std::vector<int>& zs,
-                            const std::vector<int>& ys,
-                            double p_noise,
-                            std::mt19937_64& rng,
-                            const PauliGates& G)
+// Add depolarizing noise where each data qubit independently undergoes a random X, Y,
+// or Z error with probability p
+void inject_noise(State& psi,
+                  const SurfaceCode &sc,
+                  double p_noise,
+                  std::mt19937_64& rng)
 {
-    // fixed Pauli injections
-    for (int q : xs) { check_data_range(q, sc.d); apply_1q(G.Xg, psi, q); }
-    for (int q : zs) { check_data_range(q, sc.d); apply_1q(G.Zg, psi, q); }
-    for (int q : ys) { check_data_range(q, sc.d); apply_1q(G.Xg, psi, q); apply_1q(G.Zg, psi, q); }
-
-    // Add depolarizing noise where each data qubit independently undergoes a random X, Y,
-    // or Z error with probability p
-    if (p_noise > 0.0) {
-        std::bernoulli_distribution coin(p_noise);
-        std::uniform_int_distribution<int> which(0, 2); // 0:X,1:Z,2:Y
-        for (int q = 0; q < sc.n_data; ++q) {
-            if (coin(rng)) {
-                int k = which(rng);
-                apply_pauli(k, psi, q, G);
-            }
-        }
+    if (p_noise <= 0.0) return;
+    QC_STATS_SCOPE("surface.inject", psi.size());
+    std::bernoulli_distribution coin(p_noise);
+    std::uniform_int_distribution<int> which(0, 2); // 0:X,1:Z,2:Y
+    std::uint64_t xm = 0, zm = 0;
+    for (int q = 0; q < sc.n_data; ++q) {
+        if (coin(rng)) add_pauli(which(rng), q, xm, zm);
     }
+    apply_pauli_string(psi, xm, zm);
 }
 
 } // namespace
@@ -108,6 +142,19 @@ int main(int argc, char** argv) {
     bool have_seed = false;
     std::uint64_t seed = 0;
     int d = 3;
+    bool rotated = false;
+    bool show_stats = false;
+    const char* trace_path = nullptr;
+    int shots = 0;
+    int sim_threads = 1, decode_threads = 1, batch = 64;
+    bool have_batch = false;
+    std::vector<int> sweep_d;
+    std::vector<double> sweep_p;
+    int target_failures = 100, sweep_threads = 0;
+    double target_ci = 0.0;
+    const char* out_path = nullptr;
+    bool exact = false;
+    int enumerate_w = -1;
 
     // --- parse CLI ---
     for (int i = 1; i < argc; ++i) {
@@ -119,6 +166,8 @@ int main(int argc, char** argv) {
                 std::cerr << "Error: --d must be odd integer >= 3\n";
                 return 1;
             }            
+        } else if (std::strcmp(argv[i], "--rotated") == 0) {
+            rotated = true;
         } else if (std::strcmp(argv[i], "--x") == 0) {
             int q; if (!parse_next_int(argc, argv, i, q)) { usage(argv[0]); return 1; }
             xs.push_back(q);
@@ -138,6 +187,79 @@ int main(int argc, char** argv) {
                 std::cerr << "Error: --noise-p must be in [0,1]\n";
                 return 1;
             }
+        } else if (std::strcmp(argv[i], "--shots") == 0) {
+            if (!parse_next_int(argc, argv, i, shots) || shots <= 0) {
+                std::cerr << "Error: --shots must be positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--sim-threads") == 0) {
+            if (!parse_next_int(argc, argv, i, sim_threads) || sim_threads <= 0) {
+                std::cerr << "Error: --sim-threads must be positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--decode-threads") == 0) {
+            if (!parse_next_int(argc, argv, i, decode_threads) || decode_threads <= 0) {
+                std::cerr << "Error: --decode-threads must be positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--batch") == 0) {
+            if (!parse_next_int(argc, argv, i, batch) || batch <= 0) {
+                std::cerr << "Error: --batch must be positive integer\n";
+                return 1;
+            }
+            have_batch = true;
+        } else if (std::strcmp(argv[i], "--sweep-d") == 0) {
+            if (!parse_next_int_list(argc, argv, i, sweep_d)) {
+                std::cerr << "Error: --sweep-d expects a comma-separated list of odd integers >= 3\n";
+                return 1;
+            }
+            for (int v : sweep_d) {
+                if (v < 3 || (v % 2) == 0) {
+                    std::cerr << "Error: --sweep-d must contain odd integers >= 3\n";
+                    return 1;
+                }
+            }
+        } else if (std::strcmp(argv[i], "--sweep-p") == 0) {
+            if (!parse_next_double_list(argc, argv, i, sweep_p)) {
+                std::cerr << "Error: --sweep-p expects a comma-separated list of probabilities\n";
+                return 1;
+            }
+            for (double v : sweep_p) {
+                if (v < 0.0 || v > 1.0) {
+                    std::cerr << "Error: --sweep-p values must be in [0,1]\n";
+                    return 1;
+                }
+            }
+        } else if (std::strcmp(argv[i], "--target-failures") == 0) {
+            if (!parse_next_int(argc, argv, i, target_failures) || target_failures < 0) {
+                std::cerr << "Error: --target-failures must be non-negative integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--target-ci") == 0) {
+            if (!parse_next_double(argc, argv, i, target_ci) || target_ci < 0.0) {
+                std::cerr << "Error: --target-ci must be non-negative\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--sweep-threads") == 0) {
+            if (!parse_next_int(argc, argv, i, sweep_threads) || sweep_threads <= 0) {
+                std::cerr << "Error: --sweep-threads must be positive integer\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--out") == 0) {
+            if (i + 1 >= argc) { usage(argv[0]); return 1; }
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--enumerate") == 0) {
+            if (!parse_next_int(argc, argv, i, enumerate_w) || enumerate_w < 0 || enumerate_w > 12) {
+                std::cerr << "Error: --enumerate must be an integer in 0..12\n";
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--exact") == 0) {
+            exact = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            show_stats = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 >= argc) { usage(argv[0]); return 1; }
+            trace_path = argv[++i];
         } else if (std::strcmp(argv[i], "--seed") == 0) {
             int tmp; if (!parse_next_int(argc, argv, i, tmp)) { usage(argv[0]); return 1; }
             have_seed = true;
@@ -149,32 +271,177 @@ int main(int argc, char** argv) {
         }
     }
 
-    auto sc = build_surface_code(d);
+    if (show_stats) stats::set_enabled(true);
+    if (trace_path) stats::set_tracing(true);
+
+    auto finish = [&]() -> int {
+        if (show_stats) stats::print_summary(std::cerr);
+        if (trace_path && !stats::write_chrome_trace(trace_path)) {
+            std::cerr << "Error: cannot write trace to " << trace_path << "\n";
+            return 1;
+        }
+        return 0;
+    };
+
+    if (!sweep_d.empty() || !sweep_p.empty()) {
+        if (sweep_d.empty() || sweep_p.empty()) {
+            std::cerr << "Error: --sweep-d and --sweep-p must be given together\n";
+            return 1;
+        }
+        SweepConfig cfg;
+        cfg.ds = sweep_d;
+        cfg.ps = sweep_p;
+        if (shots > 0) cfg.max_shots = static_cast<std::uint64_t>(shots);
+        cfg.target_failures = static_cast<std::uint64_t>(target_failures);
+        cfg.target_rel_ci = target_ci;
+        cfg.threads = sweep_threads;
+        if (have_batch) cfg.batch = batch;
+        cfg.have_seed = have_seed;
+        cfg.seed = seed;
+        const auto pts = run_sweep(cfg);
+
+        if (!out_path) {
+            write_sweep_csv(std::cout, pts);
+            return finish();
+        }
+        std::ofstream ofs(out_path);
+        if (!ofs) {
+            std::cerr << "Error: cannot write " << out_path << "\n";
+            return 1;
+        }
+        const std::string path(out_path);
+        const bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+        if (json) write_sweep_json(ofs, pts);
+        else      write_sweep_csv(ofs, pts);
+        for (const auto& pt : pts)
+            std::cout << "d=" << pt.d << " p=" << pt.p << " shots=" << pt.r.shots
+                      << " failures=" << pt.r.failures << " p_L=" << pt.p_L
+                      << " [" << pt.ci_lo << ", " << pt.ci_hi << "] stop=" << pt.stop << "\n";
+        return finish();
+    }
+
+    if (enumerate_w >= 0) {
+        if (!rotated) {
+            std::cerr << "Error: --enumerate needs --rotated (the bulk layout has no logical qubit)\n";
+            return 1;
+        }
+        if (enumerate_w > d * d) enumerate_w = d * d;
+        const auto res = enumerate_low_weight(d, enumerate_w);
+        std::cout << "# enumerate d=" << d << " n=" << res.n_data << " max_weight=" << res.max_weight
+                  << " elapsed=" << res.seconds << "s\n";
+        std::cout << "k,errors,failures,x_failures,z_failures\n";
+        for (int k = 0; k <= res.max_weight; ++k)
+            std::cout << k << "," << res.errors[k] << "," << res.failures[k] << ","
+                      << res.x_failures[k] << "," << res.z_failures[k] << "\n";
+        std::cout << "P_L(p) =";
+        bool first = true;
+        for (int k = 0; k <= res.max_weight; ++k) {
+            if (!res.failures[k]) continue;
+            std::cout << (first ? " " : " + ") << res.failures[k] << " (p/3)^" << k
+                      << " (1-p)^" << (res.n_data - k);
+            first = false;
+        }
+        if (first) std::cout << " 0";
+        std::cout << "  [+ up to P(weight > " << res.max_weight << ")]\n";
+        if (p_noise > 0.0)
+            std::cout << "p=" << p_noise << " P_L=" << failure_polynomial(res, p_noise)
+                      << " truncation<=" << truncation_bound(res, p_noise) << "\n";
+        return finish();
+    }
+
+    if (shots > 0) {
+        if (!rotated) {
+            std::cerr << "Error: --shots needs --rotated (the bulk layout has no logical qubit)\n";
+            return 1;
+        }
+        for (int q : xs) check_data_range(q, d);
+        for (int q : zs) check_data_range(q, d);
+        for (int q : ys) check_data_range(q, d);
+
+        PipelineConfig cfg;
+        cfg.d = d;
+        cfg.p = p_noise;
+        cfg.xs = xs; cfg.zs = zs; cfg.ys = ys;
+        cfg.max_shots = static_cast<std::uint64_t>(shots);
+        cfg.sim_threads = sim_threads;
+        cfg.decode_threads = decode_threads;
+        cfg.batch = batch;
+        cfg.have_seed = have_seed;
+        cfg.seed = seed;
+        const auto res = run_pipeline(cfg);
+
+        std::cout << "# decode d=" << d << " noise_p=" << p_noise << " seed=" << seed
+                  << " sim_threads=" << sim_threads << " decode_threads=" << decode_threads
+                  << " backend=" << (res.state_vector ? "statevector" : "parity") << "\n";
+        std::cout << "shots=" << res.shots << " failures=" << res.failures
+                  << " (X " << res.x_failures << ", Z " << res.z_failures << ")"
+                  << " p_L=" << (res.shots ? (double)res.failures / (double)res.shots : 0.0)
+                  << " elapsed=" << res.seconds << "s\n";
+        return finish();
+    }
+
+    auto sc = rotated ? build_rotated_surface_code(d) : build_surface_code(d);
+
+    if (exact) {
+        for (int q : xs) check_data_range(q, d);
+        for (int q : zs) check_data_range(q, d);
+        for (int q : ys) check_data_range(q, d);
+        ExactResult res;
+        try {
+            res = run_exact(sc, xs, zs, ys, p_noise);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        auto print_dist = [](const char* name, const std::vector<double>& dist, size_t n_checks) {
+            for (size_t s = 0; s < dist.size(); ++s) {
+                if (dist[s] <= 0.0) continue;
+                std::cout << name;
+                for (size_t k = 0; k < n_checks; ++k) std::cout << " " << ((s >> k) & 1u);
+                std::cout << " : " << dist[s] << "\n";
+            }
+        };
+        std::cout << "# exact d=" << d << " noise_p=" << p_noise << " qubits=" << res.qubits << "\n";
+        print_dist("Z", res.z_dist, sc.z_checks.size());
+        print_dist("X", res.x_dist, sc.x_checks.size());
+        if (res.have_logical)
+            std::cout << "p_X_fail=" << res.p_x_fail << " p_Z_fail=" << res.p_z_fail << "\n";
+        return finish();
+    }
 
     // RNG
     std::mt19937_64 rng(have_seed ? seed : std::random_device{}());
-    PauliGates G;
 
     // Print header
     std::cout << "# rounds=" << rounds << " noise_p=" << p_noise;
     std::cout << " seed=" << seed;
     std::cout << "\n";
 
+    // Everything before the first random draw is identical in every round: build it once
+    // and start each round from a copy into a reused buffer.
+    for (int q : xs) check_data_range(q, d);
+    for (int q : zs) check_data_range(q, d);
+    for (int q : ys) check_data_range(q, d);
+    const RoundPrefix prefix = build_prefix(sc, xs, zs, ys);
+    State psiZ, psiX; // per-round buffers, reused across rounds
+
     for (int r = 1; r <= rounds; ++r) {
         // ---- Independent run for Z syndrome ----
-        State psiZ = basis(/*n=*/sc.n_qubits(), /*index=*/0);
-        inject_fixed_and_noise(psiZ, sc, xs, zs, ys, p_noise, rng, G);
+        copy_state(prefix.z0, psiZ);
+        inject_noise(psiZ, sc, p_noise, rng);
         auto z = z_round(psiZ, sc);
 
         // ---- Independent run for X syndrome ----
-        State psiX = basis(/*n=*/sc.n_qubits(), /*index=*/0);
-        prepare_all_plus_unitary(psiX, sc); // make deterministic |+>^9
-        inject_fixed_and_noise(psiX, sc, xs, zs, ys, p_noise, rng, G);
+        copy_state(prefix.x0, psiX);
+        inject_noise(psiX, sc, p_noise, rng);
         auto x = x_round(psiX, sc);
 
-        std::cout << "round " << r << ": Z " << z[0] << " " << z[1]
-                  << " | X " << x[0] << " " << x[1] << "\n";
+        std::cout << "round " << r << ": Z";
+        for (int b : z) std::cout << " " << b;
+        std::cout << " | X";
+        for (int b : x) std::cout << " " << b;
+        std::cout << "\n";
     }
 
-    return 0;
+    return finish();
 }
@@ -0,0 +1,458 @@
+#include "mps.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace qc {
+
+namespace {
+
+double urand() {
+    thread_local std::mt19937_64 eng(std::random_device{}());
+    thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return dist(eng);
+}
+
+// Singular values at or below this fraction of the largest are numerically zero.
+constexpr double kZeroSv = 1e-15;
+
+int nonzero_rank(const std::vector<double>& S) {
+    int r = 0;
+    while (r < (int)S.size() && S[r] > kZeroSv * S[0]) ++r;
+    return std::max(r, 1);
+}
+
+// One-sided Jacobi SVD of an m×n row-major M with m >= n.
+void jacobi_svd(const std::vector<C>& M, int m, int n,
+                std::vector<C>& U, std::vector<double>& S, std::vector<C>& Vh)
+{
+    // One-sided Jacobi on the columns of W = M·V (both column-major) until they are
+    // mutually orthogonal; then σ_j = |w_j| and u_j = w_j / σ_j.
+    std::vector<C> W((std::size_t)m * n), V((std::size_t)n * n, C{0,0});
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) W[(std::size_t)j * m + i] = M[(std::size_t)i * n + j];
+    for (int j = 0; j < n; ++j) V[(std::size_t)j * n + j] = C{1,0};
+
+    constexpr int kMaxSweeps = 60;
+    constexpr double kTol = 1e-15;
+    for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        bool rotated = false;
+        for (int p = 0; p < n - 1; ++p) {
+            for (int q = p + 1; q < n; ++q) {
+                C* wp = &W[(std::size_t)p * m];
+                C* wq = &W[(std::size_t)q * m];
+                double alpha = 0.0, beta = 0.0;
+                C gamma{0,0};
+                for (int i = 0; i < m; ++i) {
+                    alpha += std::norm(wp[i]);
+                    beta  += std::norm(wq[i]);
+                    gamma += std::conj(wp[i]) * wq[i];
+                }
+                const double g = std::abs(gamma);
+                if (g <= kTol * std::sqrt(alpha * beta) || g == 0.0) continue;
+                rotated = true;
+                // Phase column q so that <w_p, w_q> is real, then a real Jacobi rotation.
+                const C e = std::conj(gamma / g);
+                const double zeta = (beta - alpha) / (2.0 * g);
+                const double t = (zeta >= 0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                const double c = 1.0 / std::sqrt(1.0 + t * t), s = c * t;
+                for (int i = 0; i < m; ++i) {
+                    const C a = wp[i], b = wq[i] * e;
+                    wp[i] = c * a - s * b;
+                    wq[i] = s * a + c * b;
+                }
+                C* vp = &V[(std::size_t)p * n];
+                C* vq = &V[(std::size_t)q * n];
+                for (int i = 0; i < n; ++i) {
+                    const C a = vp[i], b = vq[i] * e;
+                    vp[i] = c * a - s * b;
+                    vq[i] = s * a + c * b;
+                }
+            }
+        }
+        if (!rotated) break;
+    }
+
+    std::vector<double> sv(n);
+    for (int j = 0; j < n; ++j) {
+        double s2 = 0.0;
+        for (int i = 0; i < m; ++i) s2 += std::norm(W[(std::size_t)j * m + i]);
+        sv[j] = std::sqrt(s2);
+    }
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return sv[a] > sv[b]; });
+
+    const int r = n;
+    S.resize(r);
+    U.assign((std::size_t)m * r, C{0,0});
+    Vh.assign((std::size_t)r * n, C{0,0});
+    for (int k = 0; k < r; ++k) {
+        const int j = order[k];
+        S[k] = sv[j];
+        if (sv[j] > 0.0)
+            for (int i = 0; i < m; ++i) U[(std::size_t)i * r + k] = W[(std::size_t)j * m + i] / sv[j];
+        for (int i = 0; i < n; ++i) Vh[(std::size_t)k * n + i] = std::conj(V[(std::size_t)j * n + i]);
+    }
+}
+
+} // namespace
+
+// ---------- SVD ----------
+void svd(const std::vector<C>& M, int m, int n,
+         std::vector<C>& U, std::vector<double>& S, std::vector<C>& Vh)
+{
+    if (m < n) {
+        // M† = U2 S Vh2  =>  M = Vh2† S U2†
+        std::vector<C> Mh((std::size_t)n * m);
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < n; ++j) Mh[(std::size_t)j * m + i] = std::conj(M[(std::size_t)i * n + j]);
+        std::vector<C> U2, Vh2;
+        svd(Mh, n, m, U2, S, Vh2);
+        const int r = m;
+        U.assign((std::size_t)m * r, C{0,0});
+        Vh.assign((std::size_t)r * n, C{0,0});
+        for (int i = 0; i < m; ++i)
+            for (int k = 0; k < r; ++k) U[(std::size_t)i * r + k] = std::conj(Vh2[(std::size_t)k * m + i]);
+        for (int k = 0; k < r; ++k)
+            for (int j = 0; j < n; ++j) Vh[(std::size_t)k * n + j] = std::conj(U2[(std::size_t)j * r + k]);
+        return;
+    }
+
+    // Precondition: with the columns sorted by decreasing norm, M P = Q R, and the rows of R
+    // are already close to orthogonal, so Jacobi on R† = U2 S Vh2 takes a few sweeps however
+    // badly the columns of M are gauged. Then M = (Q Vh2†) S (U2† P^T).
+    std::vector<double> cn(n, 0.0);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) cn[j] += std::norm(M[(std::size_t)i * n + j]);
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::stable_sort(perm.begin(), perm.end(), [&](int a, int b) { return cn[a] > cn[b]; });
+    std::vector<C> Mp((std::size_t)m * n);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) Mp[(std::size_t)i * n + j] = M[(std::size_t)i * n + perm[j]];
+    std::vector<C> Q, R;
+    qr(Mp, m, n, Q, R);
+    std::vector<C> Rh((std::size_t)n * n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) Rh[(std::size_t)j * n + i] = std::conj(R[(std::size_t)i * n + j]);
+    std::vector<C> U2, Vh2;
+    jacobi_svd(Rh, n, n, U2, S, Vh2);
+    U.assign((std::size_t)m * n, C{0,0});
+    for (int i = 0; i < m; ++i)
+        for (int c = 0; c < n; ++c) {
+            const C q = Q[(std::size_t)i * n + c];
+            if (q == C{0,0}) continue;
+            for (int k = 0; k < n; ++k) U[(std::size_t)i * n + k] += q * std::conj(Vh2[(std::size_t)k * n + c]);
+        }
+    Vh.assign((std::size_t)n * n, C{0,0});
+    for (int k = 0; k < n; ++k)
+        for (int j = 0; j < n; ++j) Vh[(std::size_t)k * n + perm[j]] = std::conj(U2[(std::size_t)j * n + k]);
+}
+
+// ---------- QR ----------
+void qr(const std::vector<C>& M, int m, int n, std::vector<C>& Q, std::vector<C>& R) {
+    const int k = std::min(m, n);
+    // A column-major; reflector j is I - 2 v_j v_j† acting on rows j..m-1.
+    std::vector<C> A((std::size_t)m * n);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) A[(std::size_t)j * m + i] = M[(std::size_t)i * n + j];
+    std::vector<C> V((std::size_t)m * k, C{0,0});
+
+    for (int j = 0; j < k; ++j) {
+        C* a = &A[(std::size_t)j * m];
+        double x2 = 0.0;
+        for (int i = j; i < m; ++i) x2 += std::norm(a[i]);
+        const double xn = std::sqrt(x2);
+        if (xn == 0.0) continue;                       // zero column: reflector is I
+        // v = x - alpha e_j with alpha = -e^{i arg x_j} |x|, so there is no cancellation.
+        const C ph = std::abs(a[j]) > 0.0 ? a[j] / std::abs(a[j]) : C{1,0};
+        C* v = &V[(std::size_t)j * m];
+        for (int i = j; i < m; ++i) v[i] = a[i];
+        v[j] += ph * xn;
+        double v2 = 0.0;
+        for (int i = j; i < m; ++i) v2 += std::norm(v[i]);
+        const double inv = 1.0 / std::sqrt(v2);
+        for (int i = j; i < m; ++i) v[i] *= inv;
+        for (int c = j; c < n; ++c) {
+            C* col = &A[(std::size_t)c * m];
+            C s{0,0};
+            for (int i = j; i < m; ++i) s += std::conj(v[i]) * col[i];
+            s *= 2.0;
+            for (int i = j; i < m; ++i) col[i] -= s * v[i];
+        }
+    }
+
+    R.assign((std::size_t)k * n, C{0,0});
+    for (int i = 0; i < k; ++i)
+        for (int j = i; j < n; ++j) R[(std::size_t)i * n + j] = A[(std::size_t)j * m + i];
+
+    // Q = H_0 ··· H_{k-1} applied to the first k columns of the identity, column-major.
+    std::vector<C> Qc((std::size_t)m * k, C{0,0});
+    for (int j = 0; j < k; ++j) Qc[(std::size_t)j * m + j] = C{1,0};
+    for (int j = k - 1; j >= 0; --j) {
+        const C* v = &V[(std::size_t)j * m];
+        for (int c = j; c < k; ++c) {
+            C* col = &Qc[(std::size_t)c * m];
+            C s{0,0};
+            for (int i = j; i < m; ++i) s += std::conj(v[i]) * col[i];
+            s *= 2.0;
+            for (int i = j; i < m; ++i) col[i] -= s * v[i];
+        }
+    }
+    Q.resize((std::size_t)m * k);
+    for (int i = 0; i < m; ++i)
+        for (int c = 0; c < k; ++c) Q[(std::size_t)i * k + c] = Qc[(std::size_t)c * m + i];
+}
+
+// ---------- Mps ----------
+Mps::Mps(int n_qubits, std::uint64_t index, MpsConfig cfg) : sites_(n_qubits), cfg_(cfg) {
+    assert(n_qubits >= 1 && n_qubits <= 64 && cfg.max_bond >= 1);
+    for (int k = 0; k < n_qubits; ++k) {
+        sites_[k].a.assign(2, C{0,0});
+        sites_[k].a[(index >> k) & 1ull] = C{1,0};
+    }
+}
+
+int Mps::max_bond_dim() const {
+    int b = 1;
+    for (const auto& s : sites_) b = std::max(b, s.dr);
+    return b;
+}
+
+std::size_t Mps::n_amplitudes() const {
+    std::size_t n = 0;
+    for (const auto& s : sites_) n += s.a.size();
+    return n;
+}
+
+C Mps::amplitude(std::uint64_t index) const {
+    std::vector<C> v{C{1,0}}, w;
+    for (int k = 0; k < n_qubits(); ++k) {
+        const Site& A = sites_[k];
+        const int s = (index >> k) & 1ull;
+        w.assign(A.dr, C{0,0});
+        for (int l = 0; l < A.dl; ++l)
+            for (int r = 0; r < A.dr; ++r) w[r] += v[l] * A.a[(l * 2 + s) * A.dr + r];
+        v.swap(w);
+    }
+    return v[0];
+}
+
+State Mps::to_state() const {
+    // psi[bits][r] over the first k sites, bits with qubit 0 as LSB.
+    std::vector<C> cur{C{1,0}}, next;
+    std::size_t dim = 1;
+    for (int k = 0; k < n_qubits(); ++k) {
+        const Site& A = sites_[k];
+        next.assign(dim * 2 * A.dr, C{0,0});
+        for (std::size_t bits = 0; bits < dim; ++bits)
+            for (int l = 0; l < A.dl; ++l) {
+                const C x = cur[bits * A.dl + l];
+                if (x == C{0,0}) continue;
+                for (int s = 0; s < 2; ++s)
+                    for (int r = 0; r < A.dr; ++r)
+                        next[((std::size_t(s) << k | bits) * A.dr) + r] += x * A.a[(l * 2 + s) * A.dr + r];
+            }
+        cur.swap(next);
+        dim *= 2;
+    }
+    return cur;
+}
+
+// Shift the orthogonality centre one site at a time. Each step is an exact QR (rightward) or
+// LQ (leftward) split, so it never adds truncation error and never grows a bond; only the
+// gate updates in apply_adjacent need an SVD.
+void Mps::move_center(int to) {
+    std::vector<C> Q, R;
+    while (center_ < to) {
+        Site& A = sites_[center_];
+        Site& B = sites_[center_ + 1];
+        // A[(l,s)][m] = Q[(l,s)][j] R[j][m]; R moves into B.
+        qr(A.a, A.dl * 2, A.dr, Q, R);
+        const int keep = std::min(A.dl * 2, A.dr);
+        std::vector<C> b((std::size_t)keep * 2 * B.dr, C{0,0});
+        for (int j = 0; j < keep; ++j)
+            for (int m = j; m < A.dr; ++m) {
+                const C f = R[(std::size_t)j * A.dr + m];
+                if (f == C{0,0}) continue;
+                for (int sr = 0; sr < 2 * B.dr; ++sr) b[(std::size_t)j * 2 * B.dr + sr] += f * B.a[(std::size_t)m * 2 * B.dr + sr];
+            }
+        A.a.swap(Q); A.dr = keep;
+        B.a.swap(b); B.dl = keep;
+        ++center_;
+    }
+    while (center_ > to) {
+        Site& A = sites_[center_];
+        Site& P = sites_[center_ - 1];
+        // LQ from the QR of A†: A = R† Q†, Q† becomes A and R† moves into P.
+        const int rows = A.dl, cols = 2 * A.dr;
+        std::vector<C> Ah((std::size_t)cols * rows);
+        for (int i = 0; i < rows; ++i)
+            for (int c = 0; c < cols; ++c) Ah[(std::size_t)c * rows + i] = std::conj(A.a[(std::size_t)i * cols + c]);
+        qr(Ah, cols, rows, Q, R);
+        const int keep = std::min(rows, cols);
+        std::vector<C> a((std::size_t)keep * cols);
+        for (int j = 0; j < keep; ++j)
+            for (int c = 0; c < cols; ++c) a[(std::size_t)j * cols + c] = std::conj(Q[(std::size_t)c * keep + j]);
+        std::vector<C> p((std::size_t)P.dl * 2 * keep, C{0,0});
+        for (int ls = 0; ls < P.dl * 2; ++ls)
+            for (int m = 0; m < rows; ++m) {
+                const C x = P.a[(std::size_t)ls * P.dr + m];
+                if (x == C{0,0}) continue;
+                for (int j = 0; j <= std::min(m, keep - 1); ++j)
+                    p[(std::size_t)ls * keep + j] += x * std::conj(R[(std::size_t)j * rows + m]);
+            }
+        A.a.swap(a); A.dl = keep;
+        P.a.swap(p); P.dr = keep;
+        --center_;
+    }
+}
+
+// Gate on sites (k, k+1); site k+1 is the high bit of U4.
+void Mps::apply_adjacent(const C U4[4][4], int k) {
+    move_center(k);
+    Site& A = sites_[k];
+    Site& B = sites_[k + 1];
+    const int dl = A.dl, mid = A.dr, dr = B.dr;
+    QC_STATS_SCOPE("mps.apply_2q", (std::size_t)dl * 4 * dr);
+
+    // theta[l][s1][s2][r]
+    std::vector<C> theta((std::size_t)dl * 4 * dr, C{0,0});
+    for (int l = 0; l < dl; ++l)
+        for (int s1 = 0; s1 < 2; ++s1)
+            for (int m = 0; m < mid; ++m) {
+                const C x = A.a[(std::size_t)(l * 2 + s1) * mid + m];
+                if (x == C{0,0}) continue;
+                for (int s2 = 0; s2 < 2; ++s2)
+                    for (int r = 0; r < dr; ++r)
+                        theta[(((std::size_t)l * 2 + s1) * 2 + s2) * dr + r] += x * B.a[(std::size_t)(m * 2 + s2) * dr + r];
+            }
+    // M[(l,t1)][(t2,r)] = Σ U4[t2 t1][s2 s1] theta[l][s1][s2][r]
+    std::vector<C> M(theta.size(), C{0,0});
+    for (int l = 0; l < dl; ++l)
+        for (int t1 = 0; t1 < 2; ++t1)
+            for (int t2 = 0; t2 < 2; ++t2)
+                for (int s1 = 0; s1 < 2; ++s1)
+                    for (int s2 = 0; s2 < 2; ++s2) {
+                        const C u = U4[t2 * 2 + t1][s2 * 2 + s1];
+                        if (u == C{0,0}) continue;
+                        const C* src = &theta[(((std::size_t)l * 2 + s1) * 2 + s2) * dr];
+                        C* dst = &M[(((std::size_t)l * 2 + t1) * 2 + t2) * dr];
+                        for (int r = 0; r < dr; ++r) dst[r] += u * src[r];
+                    }
+
+    std::vector<C> U, Vh;
+    std::vector<double> S;
+    svd(M, dl * 2, 2 * dr, U, S, Vh);
+    const int R = (int)S.size();
+
+    // Drop from the small end within the cutoff, then cap at max_bond.
+    double total = 0.0;
+    for (double s : S) total += s * s;
+    int keep = nonzero_rank(S);
+    double dropped = 0.0;
+    for (int j = keep; j < R; ++j) dropped += S[j] * S[j];
+    while (keep > 1 && dropped + S[keep - 1] * S[keep - 1] <= cfg_.cutoff * total) {
+        --keep;
+        dropped += S[keep] * S[keep];
+    }
+    while (keep > cfg_.max_bond) {
+        --keep;
+        dropped += S[keep] * S[keep];
+    }
+    if (total > 0.0) trunc_err_ += dropped / total;
+    const double renorm = (total > dropped) ? std::sqrt(total / (total - dropped)) : 1.0;
+
+    std::vector<C> a((std::size_t)dl * 2 * keep), b((std::size_t)keep * 2 * dr);
+    for (int i = 0; i < dl * 2; ++i)
+        for (int j = 0; j < keep; ++j) a[(std::size_t)i * keep + j] = U[(std::size_t)i * R + j];
+    for (int j = 0; j < keep; ++j)
+        for (int c = 0; c < 2 * dr; ++c) b[(std::size_t)j * 2 * dr + c] = S[j] * renorm * Vh[(std::size_t)j * 2 * dr + c];
+    A.a.swap(a); A.dr = keep;
+    B.a.swap(b); B.dl = keep;
+    center_ = k + 1;
+}
+
+void apply_1q(const C U[2][2], Mps& psi, int target) {
+    auto& A = psi.sites_[target];
+    const std::size_t stride = A.dr;
+    for (int l = 0; l < A.dl; ++l) {
+        C* x0 = &A.a[(std::size_t)(l * 2) * stride];
+        C* x1 = x0 + stride;
+        for (std::size_t r = 0; r < stride; ++r) {
+            const C a = x0[r], b = x1[r];
+            x0[r] = U[0][0] * a + U[0][1] * b;
+            x1[r] = U[1][0] * a + U[1][1] * b;
+        }
+    }
+}
+
+void apply_2q(const C U4[4][4], Mps& psi, int qA, int qB) {
+    assert(qA != qB);
+    static const C kSwap[4][4] = {
+        {C{1,0}, C{0,0}, C{0,0}, C{0,0}},
+        {C{0,0}, C{0,0}, C{1,0}, C{0,0}},
+        {C{0,0}, C{1,0}, C{0,0}, C{0,0}},
+        {C{0,0}, C{0,0}, C{0,0}, C{1,0}},
+    };
+    const int lo = std::min(qA, qB), hi = std::max(qA, qB);
+    // Bring qubit hi down to site lo+1; it stays the high bit of U4 there.
+    for (int k = hi - 1; k > lo; --k) psi.apply_adjacent(kSwap, k);
+    psi.apply_adjacent(U4, lo);
+    for (int k = lo + 1; k < hi; ++k) psi.apply_adjacent(kSwap, k);
+}
+
+void apply_controlled_1q(const C U[2][2], Mps& psi, int control, int target) {
+    C U4[4][4] = {};
+    // Same layout as qc.cc's make_controlled_U.
+    if (control > target) {
+        U4[0][0] = U4[1][1] = C{1,0};
+        U4[2][2] = U[0][0]; U4[2][3] = U[0][1];
+        U4[3][2] = U[1][0]; U4[3][3] = U[1][1];
+    } else {
+        U4[0][0] = U4[2][2] = C{1,0};
+        U4[1][1] = U[0][0]; U4[1][3] = U[0][1];
+        U4[3][1] = U[1][0]; U4[3][3] = U[1][1];
+    }
+    apply_2q(U4, psi, control, target);
+}
+
+// With the centre on target, the reduced probabilities are the slice norms of its tensor.
+int measure_qubit_Z(Mps& psi, int target) {
+    psi.move_center(target);
+    auto& A = psi.sites_[target];
+    QC_STATS_SCOPE("mps.measure", A.a.size());
+    double p[2] = {0.0, 0.0};
+    for (int l = 0; l < A.dl; ++l)
+        for (int s = 0; s < 2; ++s)
+            for (int r = 0; r < A.dr; ++r) p[s] += std::norm(A.a[(std::size_t)(l * 2 + s) * A.dr + r]);
+    const double tot = p[0] + p[1];
+    const int outcome = (tot > 0.0 && urand() * tot >= p[0]) ? 1 : 0;
+    const double scale = p[outcome] > 0.0 ? 1.0 / std::sqrt(p[outcome]) : 0.0;
+    for (int l = 0; l < A.dl; ++l)
+        for (int s = 0; s < 2; ++s)
+            for (int r = 0; r < A.dr; ++r) {
+                C& x = A.a[(std::size_t)(l * 2 + s) * A.dr + r];
+                x = (s == outcome) ? x * scale : C{0,0};
+            }
+    return outcome;
+}
+
+std::uint64_t measure_all(Mps& psi) {
+    std::uint64_t bits = 0;
+    for (int q = 0; q < psi.n_qubits(); ++q)
+        bits |= std::uint64_t(measure_qubit_Z(psi, q)) << q;
+    return bits;
+}
+
+std::uint64_t sample(const Mps& psi) {
+    Mps copy = psi;
+    return measure_all(copy);
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "qc.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace qc {
+
+// Matrix-product state over the qubit order 0..n-1 (site k = qubit k), so memory and time
+// follow the entanglement across that ordering instead of 2^n. Gates use the same
+// conventions as the dense kernels in qc.h (U4 rows ordered (high bit)*2 + low bit).
+//
+// Every two-site update is an SVD of the contracted pair; singular values are dropped from
+// the small end while the discarded weight stays within `cutoff` (relative), then capped at
+// `max_bond`. The discarded weight is renormalized away and accumulated in
+// truncation_error(): 1 - fidelity with the exact state is approximately that sum.
+struct MpsConfig {
+    int max_bond = 64;
+    double cutoff = 1e-12;
+};
+
+class Mps {
+public:
+    // Product state |index> on n_qubits. Basis indices (index, amplitude(), measure_all(),
+    // sample()) are 64-bit words, so n_qubits is limited to 1..64.
+    explicit Mps(int n_qubits, std::uint64_t index = 0, MpsConfig cfg = {});
+
+    int n_qubits() const { return (int)sites_.size(); }
+    const MpsConfig& config() const { return cfg_; }
+    int max_bond_dim() const;
+    std::size_t n_amplitudes() const;       // complex numbers stored over all sites
+    double truncation_error() const { return trunc_err_; }
+
+    C amplitude(std::uint64_t index) const;
+    // Dense copy; only sensible for small n.
+    State to_state() const;
+
+private:
+    // Site tensor A[l][s][r], stored at (l*2 + s)*dr + r.
+    struct Site {
+        int dl = 1, dr = 1;
+        std::vector<C> a;
+    };
+
+    void move_center(int to);
+    void apply_adjacent(const C U4[4][4], int k);
+
+    std::vector<Site> sites_;
+    MpsConfig cfg_;
+    int center_ = 0;            // sites < center_ left-, sites > center_ right-orthogonal
+    double trunc_err_ = 0.0;
+
+    friend void apply_1q(const C U[2][2], Mps& psi, int target);
+    friend void apply_2q(const C U4[4][4], Mps& psi, int qA, int qB);
+    friend int measure_qubit_Z(Mps& psi, int target);
+};
+
+void apply_1q(const C U[2][2], Mps& psi, int target);
+// Non-adjacent pairs are routed with nearest-neighbour SWAPs and swapped back afterwards.
+void apply_2q(const C U4[4][4], Mps& psi, int qA, int qB);
+void apply_controlled_1q(const C U[2][2], Mps& psi, int control, int target);
+
+int measure_qubit_Z(Mps& psi, int target);
+// Measure every qubit (collapsing psi); bit k of the result is qubit k.
+std::uint64_t measure_all(Mps& psi);
+// Draw one bitstring from |psi|^2 without disturbing psi.
+std::uint64_t sample(const Mps& psi);
+
+// Thin SVD of the row-major m×n matrix M = U·diag(S)·Vh by one-sided Jacobi rotations on
+// the R factor of a norm-pivoted QR; U is m×r, Vh is r×n (row-major), r = min(m, n),
+// S descending.
+void svd(const std::vector<C>& M, int m, int n,
+         std::vector<C>& U, std::vector<double>& S, std::vector<C>& Vh);
+
+// Thin QR of the row-major m×n matrix M = Q·R by Householder reflections; Q is m×k with
+// orthonormal columns, R is k×n upper triangular (both row-major), k = min(m, n).
+void qr(const std::vector<C>& M, int m, int n, std::vector<C>& Q, std::vector<C>& R);
+
+}
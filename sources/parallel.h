@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace qc {
+
+// Number of workers parallel_for() would use for n items with at least min_chunk per worker.
+inline unsigned parallel_workers(std::size_t n, std::size_t min_chunk) {
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t by_size = min_chunk ? n / min_chunk : n;
+    return static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(hw, by_size)));
+}
+
+// Split [0, n) into contiguous chunks and call f(begin, end, worker) on each, one thread per
+// chunk. Ranges below 2*min_chunk run inline on the caller, so small states pay nothing.
+template <class F>
+void parallel_for(std::size_t n, std::size_t min_chunk, F&& f) {
+    const unsigned w = parallel_workers(n, min_chunk);
+    if (w <= 1) { f(std::size_t{0}, n, 0u); return; }
+    std::vector<std::thread> pool;
+    pool.reserve(w - 1);
+    const std::size_t chunk = (n + w - 1) / w;
+    for (unsigned k = 1; k < w; ++k) {
+        const std::size_t b = std::min(n, k * chunk), e = std::min(n, b + chunk);
+        pool.emplace_back([&f, b, e, k] { f(b, e, k); });
+    }
+    f(std::size_t{0}, std::min(n, chunk), 0u);
+    for (auto& t : pool) t.join();
+}
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace qc {
+
+// Bounded lock-free multi-producer/multi-consumer queue (Vyukov's sequence-numbered ring).
+// Capacity is rounded up to a power of two. A full queue makes push() wait, which is the
+// backpressure that keeps a producer/consumer pipeline's memory bounded.
+//
+// try_push/try_pop never block. push() and pop() take the same lock-free path first and only
+// sleep (std::atomic::wait on a push or pop counter) when the queue is full or empty, so an
+// idle stage costs no CPU. close() marks the end of input: pop() then drains what is left
+// and returns false.
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_  = cap - 1;
+        cells_ = std::make_unique<Cell[]>(cap);
+        for (std::size_t i = 0; i < cap; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Moves from v only on success.
+    bool try_push(T& v) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & mask_];
+            const std::size_t seq = c.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.data = std::move(v);
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    pushes_.fetch_add(1, std::memory_order_release);
+                    pushes_.notify_one();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& out) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& c = cells_[pos & mask_];
+            const std::size_t seq = c.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(c.data);
+                    c.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    pops_.fetch_add(1, std::memory_order_release);
+                    pops_.notify_one();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(T v) {
+        for (;;) {
+            // Read the counter before trying, so a pop between the failed try and the wait
+            // changes it and the wait returns at once.
+            const std::uint32_t seen = pops_.load(std::memory_order_acquire);
+            if (try_push(v)) return;
+            pops_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    // Blocks until an item arrives (true) or the queue is closed and empty (false).
+    bool pop(T& out) {
+        for (;;) {
+            const std::uint32_t seen = pushes_.load(std::memory_order_acquire);
+            if (try_pop(out)) return true;
+            // Producers publish before they close, so empty-after-closed means done.
+            if (closed_.load(std::memory_order_acquire)) return try_pop(out);
+            pushes_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    // No more pushes; wakes every consumer blocked in pop().
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        pushes_.fetch_add(1, std::memory_order_release);
+        pushes_.notify_all();
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::uint32_t> pushes_{0};   // wait/notify counters, wrap freely
+    alignas(64) std::atomic<std::uint32_t> pops_{0};
+    std::atomic<bool> closed_{false};
+};
+
+}
@@ -1,4 +1,6 @@
 #include "qc.h"
+#include "stats.h"
+#include "parallel.h"
 
 #include <vector>
 #include <complex>
@@ -6,18 +8,24 @@
 #include <cmath>
 #include <numbers>
 #include <cstdint>
+#include <cassert>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
 
 namespace qc {
 
-// Random number generator [0,1)
+// Random number generator [0,1); one engine per thread so concurrent shots don't race.
 inline double urand() {
-    static std::mt19937_64 eng(std::random_device{}());
-    static std::uniform_real_distribution<double> dist(0.0, 1.0);
+    thread_local std::mt19937_64 eng(std::random_device{}());
+    thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
     return dist(eng);
 }
 
 void renormalize(State& psi) {
+    QC_STATS_SCOPE("renormalize", psi.size());
     double s2 = 0.0; for (auto& a : psi) s2 += std::norm(a);
     if (s2 <= 0.0) return;                 // already zero vector -> skip
     double s = std::sqrt(s2);
@@ -26,34 +34,101 @@ void renormalize(State& psi) {
 
 // construct |basis⟩ 
 State basis(int n_qubits, std::uint64_t index) {
+    QC_STATS_SCOPE("basis", 1ull << n_qubits);
     const std::size_t N = 1ull << n_qubits;
     State psi(N, C{0,0});
     if (index < N) psi[index] = C{1,0};
     return psi;
 }
 
-// Apply the 1-qubit gate U to the target qubit (O(2^n)).
-// Bit numbering: LSB = 0. U is a 2×2 row-major matrix.
-void apply_1q(const C U[2][2], State& psi, int target) {
+// 4 MiB of amplitudes per worker before copying in parallel pays off.
+constexpr std::size_t kCopyChunk = 1ull << 18;
+
+void copy_state(const State& src, State& dst) {
+    QC_STATS_SCOPE("copy_state", src.size());
+    dst.resize(src.size());                 // no reallocation when capacity suffices
+    const C* s = src.data();
+    C* d = dst.data();
+    parallel_for(src.size(), kCopyChunk, [&](std::size_t b, std::size_t e, unsigned) {
+        std::memcpy(static_cast<void*>(d + b), s + b, (e - b) * sizeof(C));
+    });
+}
+
+State fork(const State& psi) {
+    State out;
+    copy_state(psi, out);
+    return out;
+}
+
+namespace {
+
+// Low targets (step = 1..32) leave the inner `off` loop too short for the runtime-bounded
+// loop to pay off; with the target as a template parameter the bound is a constant and the
+// compiler fully unrolls/vectorizes it. Targets >= kLow1q take the generic path.
+constexpr int kLow1q = 6;
+constexpr int kLow2q = 4;
+
+template <int T>
+void apply_1q_fixed(const C U[2][2], State& psi) {
+    constexpr std::size_t step  = 1ull << T;
+    constexpr std::size_t block = step << 1;
+    const std::size_t N = psi.size();
+    const C u00 = U[0][0], u01 = U[0][1], u10 = U[1][0], u11 = U[1][1];
+    C* p = psi.data();
+    for (std::size_t base = 0; base < N; base += block) {
+        for (std::size_t off = 0; off < step; ++off) {
+            const C a = p[base + off], b = p[base + off + step];
+            p[base + off]        = u00*a + u01*b;
+            p[base + off + step] = u10*a + u11*b;
+        }
+    }
+}
+
+void apply_1q_generic(const C U[2][2], State& psi, int target) {
     const std::size_t N   = psi.size();
     const std::size_t step  = 1ull << target;   // 0100...
     const std::size_t block = step << 1;        // 1000...
+    const C u00 = U[0][0], u01 = U[0][1], u10 = U[1][0], u11 = U[1][1];
 
     for (std::size_t base = 0; base < N; base += block) {
         for (std::size_t off = 0; off < step; ++off) {
             const std::size_t i0 = base + off;       // target bit = 0
             const std::size_t i1 = i0 + step;        // target bit = 1
             const C a = psi[i0], b = psi[i1];
-            psi[i0] = U[0][0]*a + U[0][1]*b;
-            psi[i1] = U[1][0]*a + U[1][1]*b;
+            psi[i0] = u00*a + u01*b;
+            psi[i1] = u10*a + u11*b;
         }
     }
 }
 
-// Apply an arbitrary 2-qubit gate U4 (4×4) to qubits (qA, qB) (order-agnostic).
-void apply_2q(const C U4[4][4], State& psi, int qA, int qB) {
-    const int low  = std::min(qA, qB);
-    const int high = std::max(qA, qB);
+template <int L>
+void apply_2q_fixed_low(const C U4[4][4], State& psi, int high) {
+    constexpr std::size_t sL = 1ull << L;
+    const std::size_t sH = 1ull << high;
+    const std::size_t N  = psi.size();
+    C u[4][4];
+    for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) u[r][c] = U4[r][c];
+    C* p = psi.data();
+
+    for (std::size_t base = 0; base < N; base += (sH << 1)) {
+        for (std::size_t mid = 0; mid < sH; mid += (sL << 1)) {
+            for (std::size_t off = 0; off < sL; ++off) {
+                const std::size_t i00 = base + mid + off;
+                const std::size_t i01 = i00 + sL;
+                const std::size_t i10 = i00 + sH;
+                const std::size_t i11 = i10 + sL;
+
+                const C v00 = p[i00], v01 = p[i01], v10 = p[i10], v11 = p[i11];
+                p[i00] = u[0][0]*v00 + u[0][1]*v01 + u[0][2]*v10 + u[0][3]*v11;
+                p[i01] = u[1][0]*v00 + u[1][1]*v01 + u[1][2]*v10 + u[1][3]*v11;
+                p[i10] = u[2][0]*v00 + u[2][1]*v01 + u[2][2]*v10 + u[2][3]*v11;
+                p[i11] = u[3][0]*v00 + u[3][1]*v01 + u[3][2]*v10 + u[3][3]*v11;
+            }
+        }
+    }
+}
+
+void apply_2q_generic(const C U4[4][4], State& psi, int low, int high) {
     const std::size_t sL = 1ull << low;
     const std::size_t sH = 1ull << high;
     const std::size_t N  = psi.size();
@@ -78,6 +153,41 @@ void apply_2q(const C U4[4][4], State& psi, int qA, int qB) {
     }
 }
 
+// Jump tables indexed by the (low) target bit.
+using Apply1qFn = void (*)(const C[2][2], State&);
+using Apply2qFn = void (*)(const C[4][4], State&, int);
+
+template <std::size_t... Ts>
+constexpr std::array<Apply1qFn, sizeof...(Ts)> make_1q_table(std::index_sequence<Ts...>) {
+    return {&apply_1q_fixed<(int)Ts>...};
+}
+template <std::size_t... Ls>
+constexpr std::array<Apply2qFn, sizeof...(Ls)> make_2q_table(std::index_sequence<Ls...>) {
+    return {&apply_2q_fixed_low<(int)Ls>...};
+}
+
+constexpr auto kApply1q = make_1q_table(std::make_index_sequence<kLow1q>{});
+constexpr auto kApply2q = make_2q_table(std::make_index_sequence<kLow2q>{});
+
+} // namespace
+
+// Apply the 1-qubit gate U to the target qubit (O(2^n)).
+// Bit numbering: LSB = 0. U is a 2×2 row-major matrix.
+void apply_1q(const C U[2][2], State& psi, int target) {
+    QC_STATS_SCOPE("apply_1q", psi.size());
+    if (target < kLow1q) kApply1q[target](U, psi);
+    else                 apply_1q_generic(U, psi, target);
+}
+
+// Apply an arbitrary 2-qubit gate U4 (4×4) to qubits (qA, qB) (order-agnostic).
+void apply_2q(const C U4[4][4], State& psi, int qA, int qB) {
+    QC_STATS_SCOPE("apply_2q", psi.size());
+    const int low  = std::min(qA, qB);
+    const int high = std::max(qA, qB);
+    if (low < kLow2q) kApply2q[low](U4, psi, high);
+    else              apply_2q_generic(U4, psi, low, high);
+}
+
 static void make_controlled_U(C U4[4][4], const C U[2][2], bool control_is_high) {
     for (int i = 0; i < 4; ++i) for (int j = 0; j < 4; ++j) U4[i][j] = C{0,0};
 
@@ -103,8 +213,51 @@ void apply_controlled_1q(const C U[2][2], State& psi, int control, int target) {
     apply_2q(U4, psi, control, target);
 }
 
+// All CNOTs of the layer commute (controls are never targets), so the combined map is
+// i -> i ^ flip(i) where flip depends only on control bits. It is an involution, so
+// swapping each pair once (i < j) applies the whole layer in a single pass.
+void apply_cnot_layer(State& psi, const std::vector<std::pair<int,int>>& cnots) {
+    if (cnots.empty()) return;
+    QC_STATS_SCOPE("apply_cnot_layer", psi.size());
+    const std::size_t N = psi.size();
+    for (std::size_t i = 0; i < N; ++i) {
+        std::size_t flip = 0;
+        for (const auto& [c, t] : cnots)
+            flip ^= ((i >> c) & 1ull) << t;
+        const std::size_t j = i ^ flip;
+        if (j > i) std::swap(psi[i], psi[j]);
+    }
+}
+
+// P = ⊗_q X^{x_q} Z^{z_q} with each X·Z on the same qubit replaced by Y = i·XZ, so
+// P|i> = i^{|x&z|} (-1)^{|i&z|} |i^x>. The map pairs i with i^x; visit each pair once via
+// its member with the lowest bit of x clear and write both ends.
+void apply_pauli_string(State& psi, std::uint64_t xmask, std::uint64_t zmask) {
+    if (xmask == 0 && zmask == 0) return;
+    assert(!psi.empty() && ((xmask | zmask) >> std::countr_zero(psi.size())) == 0);
+    QC_STATS_SCOPE("apply_pauli_string", psi.size());
+    static constexpr C kIPow[4] = {C{1,0}, C{0,1}, C{-1,0}, C{0,-1}};
+    const C g = kIPow[std::popcount(xmask & zmask) & 3];
+    auto sign = [zmask](std::size_t i) { return (std::popcount(i & zmask) & 1) ? -1.0 : 1.0; };
+    const std::size_t N = psi.size();
+
+    if (xmask == 0) {
+        for (std::size_t i = 0; i < N; ++i) psi[i] *= g * sign(i);
+        return;
+    }
+    const std::size_t low = xmask & (~xmask + 1);
+    for (std::size_t i = 0; i < N; ++i) {
+        if (i & low) continue;
+        const std::size_t j = i ^ xmask;
+        const C a = psi[i];
+        psi[i] = g * sign(j) * psi[j];
+        psi[j] = g * sign(i) * a;
+    }
+}
+
 // Z-measurement
 std::uint64_t measure_all(State& psi) {
+    QC_STATS_SCOPE("measure_all", psi.size());
     // soft normalize
     double s2 = 0.0; for (auto& a : psi) s2 += std::norm(a);
     if (s2 > 0.0) {
@@ -126,6 +279,7 @@ std::uint64_t measure_all(State& psi) {
 // Measure a single qubit in Z basis and collapse the state.
 // Returns 0/1. Collapses in-place and renormalizes the kept subspace.
 int measure_qubit_Z(State& psi, int target) {
+    QC_STATS_SCOPE("measure_qubit_Z", psi.size());
     const std::size_t N    = psi.size();
     const std::size_t step = 1ull << target;
     const std::size_t block = step << 1;
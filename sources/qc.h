@@ -4,6 +4,8 @@
 #include <complex>
 #include <cstdint>
 #include <cmath>
+#include <string>
+#include <utility>
 
 namespace qc{
 
@@ -13,12 +15,25 @@ using State = std::vector<C>;
 State basis(int n_qubits, std::uint64_t index);
 void renormalize(State& psi);
 
+// Copy src into dst, reusing dst's buffer when it is already large enough (parallel memcpy
+// for large states). Use it to restart shots from a cached deterministic prefix.
+void copy_state(const State& src, State& dst);
+// Independent copy of psi to branch a trajectory from.
+State fork(const State& psi);
+
 std::uint64_t measure_all(State& psi);
 int measure_qubit_Z(State& psi, int target);
 
 void apply_1q(const C U[2][2], State& psi, int target);
 void apply_2q(const C U4[4][4], State& psi, int qA, int qB);
 void apply_controlled_1q(const C U[2][2], State& psi, int control, int target);
+// Apply a layer of CNOTs given as (control, target) pairs in one sweep.
+// No qubit may be both a control and a target within the layer.
+void apply_cnot_layer(State& psi, const std::vector<std::pair<int,int>>& cnots);
+// Apply the Pauli string with X on the bits of xmask and Z on the bits of zmask (Y where
+// both are set) in one in-place pass: an index XOR plus a phase from popcount parity.
+// Every set bit must name a qubit of psi (below log2(psi.size()), hence also below 64).
+void apply_pauli_string(State& psi, std::uint64_t xmask, std::uint64_t zmask);
 
 void gate_X(C U[2][2]);
 void gate_H(C U[2][2]);
@@ -26,5 +41,8 @@ void gate_Rz(C U[2][2], double theta);
 void gate_CNOT(C U4[4][4]);
 
 void pretty_print(const State& psi, int n_qubits, int max_terms, double cutoff, int precision, bool show_prob, bool show_phase);
+// Normalized probabilities as a raw float64 array (host byte order, index order).
+// Throws std::runtime_error on I/O failure.
+void export_probabilities(const State& psi, const std::string& path);
 
 }
@@ -0,0 +1,91 @@
+#include "reversible.h"
+#include "stats.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace qc {
+
+namespace {
+
+// Image of basis index i under the batch, with the phase picked up along the way.
+inline std::size_t map_index(const std::vector<RevGate>& gates, std::size_t x, C& ph) {
+    for (const auto& g : gates) {
+        switch (g.kind) {
+        case RevGate::X:
+            x ^= 1ull << g.q0;
+            break;
+        case RevGate::CNOT:
+            x ^= ((x >> g.q0) & 1ull) << g.q1;
+            break;
+        case RevGate::SWAP: {
+            const std::size_t diff = ((x >> g.q0) ^ (x >> g.q1)) & 1ull;
+            x ^= (diff << g.q0) | (diff << g.q1);
+            break;
+        }
+        case RevGate::TOFFOLI:
+            x ^= ((x >> g.q0) & (x >> g.q1) & 1ull) << g.q2;
+            break;
+        case RevGate::PHASE:
+            if ((x >> g.q0) & 1ull) ph *= g.ph;
+            break;
+        case RevGate::CPHASE:
+            if ((x >> g.q0) & (x >> g.q1) & 1ull) ph *= g.ph;
+            break;
+        }
+    }
+    return x;
+}
+
+bool has_phase(const std::vector<RevGate>& gates) {
+    for (const auto& g : gates)
+        if (g.kind == RevGate::PHASE || g.kind == RevGate::CPHASE) return true;
+    return false;
+}
+
+} // namespace
+
+void apply_reversible(const ReversibleBatch& batch, State& psi, State& scratch) {
+    if (batch.empty()) return;
+    QC_STATS_SCOPE("apply_reversible", psi.size());
+    const std::size_t N = psi.size();
+    const bool phased = has_phase(batch.gates);
+
+    scratch.resize(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        C ph{1,0};
+        const std::size_t x = map_index(batch.gates, i, ph);
+        scratch[x] = phased ? ph * psi[i] : psi[i];
+    }
+    psi.swap(scratch);
+}
+
+void apply_reversible(const ReversibleBatch& batch, State& psi) {
+    if (batch.empty()) return;
+    QC_STATS_SCOPE("apply_reversible", psi.size());
+    const std::size_t N = psi.size();
+    const bool phased = has_phase(batch.gates);
+
+    // Follow each cycle of the permutation once, carrying the displaced amplitude along;
+    // the only extra memory is one bit per amplitude.
+    std::vector<bool> done(N, false);
+    for (std::size_t start = 0; start < N; ++start) {
+        if (done[start]) continue;
+        C carry = psi[start];
+        std::size_t i = start;
+        for (;;) {
+            done[i] = true;
+            C ph{1,0};
+            const std::size_t x = map_index(batch.gates, i, ph);
+            const C moved = phased ? ph * carry : carry;
+            if (x == start) { psi[x] = moved; break; }
+            const C next = psi[x];
+            psi[x] = moved;
+            carry = next;
+            i = x;
+        }
+    }
+}
+
+}
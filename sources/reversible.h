@@ -0,0 +1,39 @@
+#pragma once
+#include "qc.h"
+
+#include <vector>
+
+namespace qc {
+
+// Classical-reversible gate: permutes basis indices (X, CNOT, SWAP, Toffoli) or multiplies
+// them by a phase (Z, CZ, P(θ)). Bit numbering: LSB = 0, as everywhere else.
+struct RevGate {
+    enum Kind { X, CNOT, SWAP, TOFFOLI, PHASE, CPHASE } kind;
+    int q0, q1, q2;   // X:q0 / CNOT:c=q0,t=q1 / SWAP:q0,q1 / TOFFOLI:c=q0,q1,t=q2 / PHASE:q0 / CPHASE:q0,q1
+    C   ph;           // phase factor for PHASE/CPHASE when the qubit(s) are 1
+};
+
+// A stretch of permutation-class gates, applied to State as one combined index map.
+struct ReversibleBatch {
+    std::vector<RevGate> gates;
+
+    ReversibleBatch& x(int q)                    { gates.push_back({RevGate::X, q, -1, -1, C{1,0}}); return *this; }
+    ReversibleBatch& cnot(int c, int t)          { gates.push_back({RevGate::CNOT, c, t, -1, C{1,0}}); return *this; }
+    ReversibleBatch& swap(int a, int b)          { gates.push_back({RevGate::SWAP, a, b, -1, C{1,0}}); return *this; }
+    ReversibleBatch& toffoli(int c0, int c1, int t) { gates.push_back({RevGate::TOFFOLI, c0, c1, t, C{1,0}}); return *this; }
+    ReversibleBatch& z(int q)                    { gates.push_back({RevGate::PHASE, q, -1, -1, C{-1,0}}); return *this; }
+    ReversibleBatch& cz(int a, int b)            { gates.push_back({RevGate::CPHASE, a, b, -1, C{-1,0}}); return *this; }
+    // diag(1, e^{iθ}) on q
+    ReversibleBatch& phase(int q, double theta)  { gates.push_back({RevGate::PHASE, q, -1, -1, std::polar(1.0, theta)}); return *this; }
+
+    bool empty() const { return gates.empty(); }
+};
+
+// Apply the whole batch in one gather/scatter sweep: psi'[f(i)] = phase(i) * psi[i], where
+// f is the composed permutation and phase(i) the product of the diagonal factors picked up
+// along the way. `scratch` is resized to psi.size() and swapped with psi (reuse it across calls).
+void apply_reversible(const ReversibleBatch& batch, State& psi, State& scratch);
+// Same, permuting psi in place cycle by cycle (no second state; one bit per amplitude).
+void apply_reversible(const ReversibleBatch& batch, State& psi);
+
+}
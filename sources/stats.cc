@@ -0,0 +1,137 @@
+#include "stats.h"
+
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include <cstring>
+
+namespace qc::stats {
+
+namespace {
+
+struct Event {
+    const char* name;
+    int tid;
+    std::int64_t ts_ns;   // relative to the trace origin
+    std::int64_t dur_ns;
+};
+
+// Cap the timeline so long runs keep bounded memory; counters keep counting.
+constexpr std::size_t kMaxEvents = 1u << 20;
+
+struct Registry {
+    std::mutex mu;
+    std::deque<Counter> counters;   // deque: stable addresses on growth
+    std::vector<Event> events;
+    std::atomic<bool> tracing{false};
+    std::atomic<std::uint64_t> dropped{0};
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+};
+
+Registry& reg() { static Registry r; return r; }
+
+int thread_index() {
+    static std::atomic<int> next{0};
+    thread_local int tid = next++;
+    return tid;
+}
+
+} // namespace
+
+Counter& counter(const char* name) {
+    auto& r = reg();
+    std::lock_guard<std::mutex> lk(r.mu);
+    for (auto& c : r.counters)
+        if (std::strcmp(c.name, name) == 0) return c;
+    r.counters.emplace_back();
+    r.counters.back().name = name;
+    return r.counters.back();
+}
+
+void set_enabled(bool on) { enabled_flag().store(on, std::memory_order_relaxed); }
+
+void set_tracing(bool on) {
+    reg().tracing.store(on, std::memory_order_relaxed);
+    if (on) set_enabled(true);
+}
+
+void reset() {
+    auto& r = reg();
+    std::lock_guard<std::mutex> lk(r.mu);
+    for (auto& c : r.counters) { c.calls = 0; c.amps = 0; c.ns = 0; }
+    r.events.clear();
+    r.dropped = 0;
+    r.origin = std::chrono::steady_clock::now();
+}
+
+void record(Counter& c, std::uint64_t amps,
+            std::chrono::steady_clock::time_point t0,
+            std::chrono::steady_clock::time_point t1) {
+    const auto dt = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    c.calls.fetch_add(1, std::memory_order_relaxed);
+    c.amps.fetch_add(amps, std::memory_order_relaxed);
+    c.ns.fetch_add(static_cast<std::uint64_t>(dt), std::memory_order_relaxed);
+
+    auto& r = reg();
+    if (!r.tracing.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lk(r.mu);
+    if (r.events.size() >= kMaxEvents) { ++r.dropped; return; }
+    const auto ts = std::chrono::duration_cast<std::chrono::nanoseconds>(t0 - r.origin).count();
+    r.events.push_back({c.name, thread_index(), ts, dt});
+}
+
+void print_summary(std::ostream& os) {
+#ifndef QC_STATS
+    os << "# stats: instrumentation compiled out (configure with -DQC_STATS=ON)\n";
+#else
+    auto& r = reg();
+    std::lock_guard<std::mutex> lk(r.mu);
+    const auto flags = os.flags();
+    const auto prec  = os.precision();
+    os << "# " << std::left << std::setw(28) << "kernel" << std::right
+       << std::setw(12) << "calls"
+       << std::setw(16) << "amps"
+       << std::setw(12) << "MB"
+       << std::setw(12) << "ms"
+       << std::setw(10) << "ns/amp" << "\n";
+    os.setf(std::ios::fixed);
+    for (const auto& c : r.counters) {
+        const std::uint64_t calls = c.calls.load(), amps = c.amps.load(), ns = c.ns.load();
+        if (calls == 0) continue;
+        os << "  " << std::left << std::setw(28) << c.name << std::right
+           << std::setw(12) << calls
+           << std::setw(16) << amps
+           << std::setw(12) << std::setprecision(1) << (double)amps * sizeof(double) * 2 / 1e6
+           << std::setw(12) << std::setprecision(3) << (double)ns / 1e6
+           << std::setw(10) << std::setprecision(2) << (amps ? (double)ns / (double)amps : 0.0)
+           << "\n";
+    }
+    if (r.dropped) os << "# trace: " << r.dropped << " events dropped (cap " << kMaxEvents << ")\n";
+    os.flags(flags);
+    os.precision(prec);
+#endif
+}
+
+bool write_chrome_trace(const std::string& path) {
+    std::ofstream ofs(path);
+    if (!ofs) return false;
+    auto& r = reg();
+    std::lock_guard<std::mutex> lk(r.mu);
+    ofs << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    ofs.setf(std::ios::fixed); ofs << std::setprecision(3);
+    for (std::size_t i = 0; i < r.events.size(); ++i) {
+        const auto& e = r.events[i];
+        ofs << "{\"name\":\"" << e.name << "\",\"cat\":\"qc\",\"ph\":\"X\",\"pid\":0"
+            << ",\"tid\":" << e.tid
+            << ",\"ts\":" << (double)e.ts_ns / 1e3
+            << ",\"dur\":" << (double)e.dur_ns / 1e3 << "}"
+            << (i + 1 < r.events.size() ? ",\n" : "\n");
+    }
+    ofs << "]}\n";
+    return static_cast<bool>(ofs);
+}
+
+} // namespace qc::stats
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Per-kernel instrumentation: call count, amplitudes touched and wall time for every
+// instrumented scope, plus an optional timeline for Chrome's trace viewer (chrome://tracing).
+// Scopes are compiled in only with -DQC_STATS (CMake option QC_STATS); at runtime they cost
+// one relaxed load until stats::set_enabled(true).
+
+namespace qc::stats {
+
+struct Counter {
+    const char* name;
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> amps{0};   // amplitudes touched
+    std::atomic<std::uint64_t> ns{0};     // wall time
+};
+
+// Registered once per name; the reference stays valid for the life of the program.
+Counter& counter(const char* name);
+
+void set_enabled(bool on);
+void set_tracing(bool on);   // also record one timeline event per scope (implies enabled)
+void reset();
+
+inline std::atomic<bool>& enabled_flag() { static std::atomic<bool> f{false}; return f; }
+inline bool enabled() { return enabled_flag().load(std::memory_order_relaxed); }
+
+// Table of all counters with calls, amplitudes, MB touched and time.
+void print_summary(std::ostream& os);
+// Chrome trace-event JSON ("X" complete events). Returns false if the file can't be written.
+bool write_chrome_trace(const std::string& path);
+
+void record(Counter& c, std::uint64_t amps,
+            std::chrono::steady_clock::time_point t0,
+            std::chrono::steady_clock::time_point t1);
+
+class Scope {
+public:
+    Scope(Counter& c, std::uint64_t amps) : c_(c), amps_(amps), on_(enabled()) {
+        if (on_) t0_ = std::chrono::steady_clock::now();
+    }
+    ~Scope() {
+        if (on_) record(c_, amps_, t0_, std::chrono::steady_clock::now());
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+private:
+    Counter& c_;
+    std::uint64_t amps_;
+    bool on_;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+} // namespace qc::stats
+
+#define QC_STATS_CAT2(a, b) a##b
+#define QC_STATS_CAT(a, b) QC_STATS_CAT2(a, b)
+
+#ifdef QC_STATS
+#define QC_STATS_SCOPE(name, amps)                                                        \
+    static ::qc::stats::Counter& QC_STATS_CAT(qc_stats_c_, __LINE__) = ::qc::stats::counter(name); \
+    ::qc::stats::Scope QC_STATS_CAT(qc_stats_s_, __LINE__)(QC_STATS_CAT(qc_stats_c_, __LINE__), (amps))
+#else
+#define QC_STATS_SCOPE(name, amps) ((void)0)
+#endif
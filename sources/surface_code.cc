@@ -1,5 +1,6 @@
 #include "qc.h"
 #include "surface_code.h"
+#include "stats.h"
 
 #include <array>
 #include <vector>
@@ -11,14 +12,16 @@ void reset_to_zero(State& psi, int q){
     if (m == 1) { C X[2][2]; gate_X(X); apply_1q(X, psi, q); }
 }
 
-// Non-destructive: from |0>^9, just apply H to make |+>^9.
+// Non-destructive: from |0> on data, just apply H to make |+>^n_data.
 void prepare_all_plus_unitary(State& psi, const SurfaceCode& sc) {
+    QC_STATS_SCOPE("surface.prepare_plus", sc.n_data * psi.size());
     C Hm[2][2]; gate_H(Hm);
     for (int d = 0; d < sc.n_data; ++d) apply_1q(Hm, psi, d);
 }
 
 // Destructive: Z-measure + X reset → |0> then H → |+>.
 void prepare_all_plus_fresh(State& psi, const SurfaceCode& sc) {
+    QC_STATS_SCOPE("surface.prepare_plus", 2 * sc.n_data * psi.size());   // measure + H
     C Hm[2][2]; gate_H(Hm);
     for (int d = 0; d < sc.n_data; ++d) {
         reset_to_zero(psi, d);
@@ -26,77 +29,157 @@ void prepare_all_plus_fresh(State& psi, const SurfaceCode& sc) {
     }
 }
 
-// Z round (CNOT data -> anc, then Z-measure on anc)
+// Z round: all anc in |0>, CNOT(data -> anc) in schedule layers, then Z-measure on anc.
 std::vector<int> z_round(State& psi, const SurfaceCode& sc) {
+    QC_STATS_SCOPE("surface.z_round", z_round_passes(sc) * psi.size());
     std::vector<int> syn(sc.z_anc.size(), 0);
-    C X1[2][2]; gate_X(X1);
-    for (size_t k = 0; k < sc.z_anc.size(); ++k){
-        const int anc = sc.z_anc[k];
-        reset_to_zero(psi, anc); // anc = |0>
-        const auto& nb = sc.z_checks[k]; // target data qubits
-        for (int t = 0; t < 4; ++t) {
-            const int dqb = nb[t];
-            apply_controlled_1q(X1, psi, /*control=*/dqb, /*target=*/anc);
-        }
-        syn[k] = measure_qubit_Z(psi, anc);
-    }
+    for (const int anc : sc.z_anc) reset_to_zero(psi, anc); // anc = |0>
+    for (const auto& layer : sc.z_layers) apply_cnot_layer(psi, layer);
+    for (size_t k = 0; k < sc.z_anc.size(); ++k) syn[k] = measure_qubit_Z(psi, sc.z_anc[k]);
     return syn;
 }
 
-// X round (anc in |+>, CNOT anc -> data, H, then Z-measure on anc)
+// X round: all anc in |+>, CNOT(anc -> data) in schedule layers, H, then Z-measure on anc.
 std::vector<int> x_round(State& psi, const SurfaceCode& sc) {
+    QC_STATS_SCOPE("surface.x_round", x_round_passes(sc) * psi.size());
     std::vector<int> syn(sc.x_anc.size(), 0);
     C Hm[2][2]; gate_H(Hm);
-    C X1[2][2]; gate_X(X1);
-    for (size_t k = 0; k < sc.x_anc.size(); ++k){
-        const int anc = sc.x_anc[k];
+    for (const int anc : sc.x_anc) {
         reset_to_zero(psi, anc); // anc = |0>
-        apply_1q(Hm, psi, anc); // anc → |+>
-        const auto& nb = sc.x_checks[k]; // target data qubits
-        for (int t = 0; t < 4; ++t) {
-            const int dqb = nb[t];
-            apply_controlled_1q(X1, psi, /*control=*/anc, /*target=*/dqb);
-        }
-        apply_1q(Hm, psi, anc); // X-measure via H + Z
-        syn[k] = measure_qubit_Z(psi, anc);
+        apply_1q(Hm, psi, anc);  // anc → |+>
     }
+    for (const auto& layer : sc.x_layers) apply_cnot_layer(psi, layer);
+    for (const int anc : sc.x_anc) apply_1q(Hm, psi, anc); // X-measure via H + Z
+    for (size_t k = 0; k < sc.x_anc.size(); ++k) syn[k] = measure_qubit_Z(psi, sc.x_anc[k]);
     return syn;
 }
 
+// Reset (measure) and measure each ancilla, plus one pass per CNOT layer.
+int z_round_passes(const SurfaceCode& sc) {
+    return 2 * (int)sc.z_anc.size() + (int)sc.z_layers.size();
+}
+
+// As z_round, plus the two H passes per ancilla.
+int x_round_passes(const SurfaceCode& sc) {
+    return 4 * (int)sc.x_anc.size() + (int)sc.x_layers.size();
+}
+
+namespace {
+
+// Corner slots of a face: NW, SW, NE, SE; -1 where the corner lies outside the patch.
+using Face = std::array<int,4>;
+constexpr int NW = 0, SW = 1, NE = 2, SE = 3;
+
+// Hook-safe orders: Z checks run "N" (NW,SW,NE,SE) so a mid-round ancilla fault leaves a
+// vertical Z pair; X checks run "Z" (NW,NE,SW,SE) so it leaves a horizontal X pair. Both
+// are perpendicular to the same-type logical (Z_L on a row, X_L on a column).
+constexpr std::array<int,4> z_order{NW, SW, NE, SE};
+constexpr std::array<int,4> x_order{NW, NE, SW, SE};
+
+// Face whose top-left data qubit is (i,j).
+Face face_corners(int i, int j, int d) {
+    Face f;
+    const int ci[4] = {i, i+1, i,   i+1};
+    const int cj[4] = {j, j,   j+1, j+1};
+    for (int t = 0; t < 4; ++t) {
+        const bool in = ci[t] >= 0 && ci[t] < d && cj[t] >= 0 && cj[t] < d;
+        f[t] = in ? data_idx(ci[t], cj[t], d) : -1;
+    }
+    return f;
+}
+
+// Layer t holds the t-th CNOT of every check. Within a layer each data qubit sits in the
+// same corner slot of at most one face, so the CNOTs are disjoint.
+std::vector<std::vector<std::pair<int,int>>> build_layers(const std::vector<Face>& faces,
+                                                          const std::vector<int>& anc,
+                                                          const std::array<int,4>& order,
+                                                          bool data_is_control) {
+    std::vector<std::vector<std::pair<int,int>>> layers(4);
+    for (int t = 0; t < 4; ++t) {
+        for (size_t k = 0; k < faces.size(); ++k) {
+            const int dq = faces[k][order[t]];
+            if (dq < 0) continue;
+            if (data_is_control) layers[t].push_back({dq, anc[k]});
+            else                 layers[t].push_back({anc[k], dq});
+        }
+    }
+    return layers;
+}
+
+// 物理インデックスの付与：data [0..d*d-1], 次に Z anc, 次に X anc
+void finalize(SurfaceCode& sc, const std::vector<Face>& z_faces, const std::vector<Face>& x_faces) {
+    auto compact = [](const Face& f) {
+        std::vector<int> nbrs;
+        for (int q : f) if (q >= 0) nbrs.push_back(q);
+        return nbrs;
+    };
+    for (const auto& f : z_faces) sc.z_checks.push_back(compact(f));
+    for (const auto& f : x_faces) sc.x_checks.push_back(compact(f));
+
+    int next = sc.n_data;
+    sc.z_anc.resize(z_faces.size());
+    for (size_t k = 0; k < z_faces.size(); ++k) sc.z_anc[k] = next++;
+    sc.x_anc.resize(x_faces.size());
+    for (size_t k = 0; k < x_faces.size(); ++k) sc.x_anc[k] = next++;
+
+    sc.z_layers = build_layers(z_faces, sc.z_anc, z_order, /*data_is_control=*/true);
+    sc.x_layers = build_layers(x_faces, sc.x_anc, x_order, /*data_is_control=*/false);
+}
+
+} // namespace
+
 SurfaceCode build_surface_code(int d) {
     assert(d >= 3 && (d % 2 == 1));
     SurfaceCode sc;
     sc.d = d;
     sc.n_data = d * d;
 
-    std::vector<std::array<int,4>> z_checks, x_checks;
+    std::vector<Face> z_faces, x_faces;
 
     // (d-1)×(d-1) のプラケット格子をチェッカーボード色分け
     for (int i = 0; i < d - 1; ++i) {
         for (int j = 0; j < d - 1; ++j) {
-            std::array<int,4> nbrs{
-                data_idx(i,   j,   d),
-                data_idx(i+1, j,   d),
-                data_idx(i,   j+1, d),
-                data_idx(i+1, j+1, d)
-            };
             if ( ((i + j) & 1) == 0 ) {
-                z_checks.push_back(nbrs);
+                z_faces.push_back(face_corners(i, j, d));
             } else {
-                x_checks.push_back(nbrs);
+                x_faces.push_back(face_corners(i, j, d));
             }
         }
     }
 
-    // 物理インデックスの付与：data [0..d*d-1], 次に Z anc, 次に X anc
-    int next = sc.n_data;
-    sc.z_anc.resize(z_checks.size());
-    for (size_t k = 0; k < z_checks.size(); ++k) sc.z_anc[k] = next++;
-    sc.x_anc.resize(x_checks.size());
-    for (size_t k = 0; k < x_checks.size(); ++k) sc.x_anc[k] = next++;
+    finalize(sc, z_faces, x_faces);
+    return sc;
+}
+
+SurfaceCode build_rotated_surface_code(int d) {
+    assert(d >= 3 && (d % 2 == 1));
+    SurfaceCode sc;
+    sc.d = d;
+    sc.n_data = d * d;
+    sc.rotated = true;
+
+    std::vector<Face> z_faces, x_faces;
+
+    // Faces (i,j) for i,j in [-1, d-1]; same checkerboard colouring as the bulk layout.
+    // Bulk faces are always kept; half-faces on the top/bottom edges are kept when X-type,
+    // half-faces on the left/right edges when Z-type. Corner faces (weight 1) never appear.
+    for (int i = -1; i < d; ++i) {
+        for (int j = -1; j < d; ++j) {
+            const bool is_z   = ((i + j) & 1) == 0;
+            const bool row_ed = (i == -1 || i == d - 1);
+            const bool col_ed = (j == -1 || j == d - 1);
+            if (row_ed && col_ed) continue;
+            if (row_ed && is_z)   continue;
+            if (col_ed && !is_z)  continue;
+            if (is_z) z_faces.push_back(face_corners(i, j, d));
+            else      x_faces.push_back(face_corners(i, j, d));
+        }
+    }
+
+    for (int j = 0; j < d; ++j) sc.logical_z.push_back(data_idx(0, j, d));
+    for (int i = 0; i < d; ++i) sc.logical_x.push_back(data_idx(i, 0, d));
 
-    sc.z_checks = std::move(z_checks);
-    sc.x_checks = std::move(x_checks);
+    finalize(sc, z_faces, x_faces);
     return sc;
 }
 
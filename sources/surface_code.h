@@ -1,6 +1,6 @@
 #pragma once
 #include "qc.h"
-#include <array>
+#include <utility>
 #include <vector>
 #include <cassert>
 
@@ -9,37 +9,59 @@ namespace qc::surface {
 // 2d index -> 1d index
 inline int data_idx(int i, int j, int d) { return i * d + j; }
 
-// Two Z-faces (TL, BR) and two X-faces (TR, BL) — checkerboard, all weight-4.
+// Checks are stored with variable weight so both layouts fit:
+//  - bulk:    (d-1)^2 weight-4 faces in a checkerboard (Z at TL), no boundary checks.
+//  - rotated: the same bulk faces plus 2(d-1) weight-2 boundary checks
+//             (X on top/bottom, Z on left/right); d^2-1 checks, one logical qubit.
 struct SurfaceCode {
     int d; // code-length
     int n_data; // = d*d
+    bool rotated = false;
     std::vector<int> z_anc;
     std::vector<int> x_anc;
 
-    std::vector<std::array<int,4>> z_checks; // z_checks[k] is pair with z_anc[k]
-    std::vector<std::array<int,4>> x_checks; // x_checks[k] is pair with x_anc[k]
+    std::vector<std::vector<int>> z_checks; // z_checks[k] is pair with z_anc[k]
+    std::vector<std::vector<int>> x_checks; // x_checks[k] is pair with x_anc[k]
+
+    // CNOT schedule as (control, target) pairs, 4 layers of disjoint gates each.
+    // Z layers: data -> anc in N order (NW,SW,NE,SE); X layers: anc -> data in Z order (NW,NE,SW,SE).
+    std::vector<std::vector<std::pair<int,int>>> z_layers;
+    std::vector<std::vector<std::pair<int,int>>> x_layers;
+
+    // Supports of the logical operators (rotated layout only; empty for bulk).
+    std::vector<int> logical_z; // Z on a row, left -> right Z boundary
+    std::vector<int> logical_x; // X on a column, top -> bottom X boundary
 
     int n_qubits() const { return n_data + (int)z_anc.size() + (int)x_anc.size(); }
 
 };
 
+// Bulk-only unrotated patch: d^2 data + (d-1)^2 ancillas.
 SurfaceCode build_surface_code(int d);
 
+// Rotated patch with weight-2 boundary checks: d^2 data + (d^2-1) ancillas = 2d^2-1 qubits.
+SurfaceCode build_rotated_surface_code(int d);
+
 // Measure in Z and (if needed) apply X to force |0>.
 void reset_to_zero(State& psi, int q);
 
-// Prepare |+>^9 non-destructively (assumes |0>^9 → just H on data 0..8).
+// Prepare |+>^n_data non-destructively (assumes |0> on data → just H on each data qubit).
 void prepare_all_plus_unitary(State& psi, const SurfaceCode& sc);
 
-// Prepare |+>^9 destructively (Z-measure + X reset on each data, then H).
+// Prepare |+>^n_data destructively (Z-measure + X reset on each data, then H).
 // WARNING: This erases any pre-existing errors/phases on data qubits.
 // Use only at the start of an independent run, before injecting errors.
 void prepare_all_plus_fresh(State& psi, const SurfaceCode& sc);
 
-// One Z stabilizer round: anc in |0>, CNOT(data -> anc), Z-measure.
+// One Z stabilizer round: anc in |0>, CNOT(data -> anc) layer by layer, Z-measure.
 std::vector<int> z_round(State& psi, const SurfaceCode& sc);
 
-// One X stabilizer round (standard): anc in |+>, CNOT(anc -> data), H, Z-measure.
+// One X stabilizer round (standard): anc in |+>, CNOT(anc -> data) layer by layer, H, Z-measure.
 std::vector<int> x_round(State& psi, const SurfaceCode& sc);
 
+// Full-state kernel passes z_round / x_round always make (the conditional X of a reset is
+// not included); the stats counters report passes × 2^n_qubits amplitudes per phase.
+int z_round_passes(const SurfaceCode& sc);
+int x_round_passes(const SurfaceCode& sc);
+
 } // namespace qc::surface
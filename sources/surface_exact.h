@@ -0,0 +1,33 @@
+#pragma once
+#include "surface_code.h"
+
+#include <vector>
+
+namespace qc::surface {
+
+// Exact code-capacity statistics from the density-matrix backend: fixed injections plus
+// depolarizing p on every data qubit, averaged analytically instead of sampled.
+//
+// Each run keeps only the data qubits and the ancillas of the family it measures (the
+// other family never touches the data during that run), so the register is
+// n_data + |family| qubits: 11 for the bulk d=3 patch (64 MiB), 13 for rotated d=3 (1 GiB).
+struct ExactResult {
+    int qubits = 0;                 // largest register used by either run
+    std::vector<double> z_dist;     // P(Z syndrome), bit k of the index = z_checks[k]
+    std::vector<double> x_dist;     // P(X syndrome), bit k of the index = x_checks[k]
+    bool have_logical = false;      // rotated layout only
+    double p_x_fail = 0.0;          // P(matching on the Z syndrome leaves Z_L flipped)
+    double p_z_fail = 0.0;          // P(matching on the X syndrome leaves X_L flipped)
+};
+
+// Largest register run_exact accepts (16·4^13 bytes = 1 GiB per density matrix).
+constexpr int kMaxDensityQubits = 13;
+
+// Throws std::runtime_error if a run would exceed kMaxDensityQubits.
+ExactResult run_exact(const SurfaceCode& sc,
+                      const std::vector<int>& xs,
+                      const std::vector<int>& zs,
+                      const std::vector<int>& ys,
+                      double p);
+
+} // namespace qc::surface
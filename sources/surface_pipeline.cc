@@ -0,0 +1,222 @@
+#include "surface_pipeline.h"
+#include "pipeline.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace qc::surface {
+
+namespace {
+
+struct ShotBatch {
+    std::vector<ErrorBits> x_err, z_err;
+    std::vector<std::vector<int>> z_syn, x_syn;
+};
+
+struct Tally {
+    std::uint64_t shots = 0, failures = 0, x_failures = 0, z_failures = 0;
+};
+
+// Per-thread shot source: RNG, fixed injections and a reused state buffer. Worker w of a run
+// with a seed draws from seed_seq{seed, w}.
+class ShotSampler {
+public:
+    ShotSampler(const PipelineConfig& cfg, const SurfaceCode& sc, const RoundPrefix* prefix,
+                unsigned worker)
+        : cfg_(cfg), sc_(sc), prefix_(prefix), rng_(make_rng(cfg, worker)), coin_(cfg.p),
+          none_(sc.n_data, 0)
+    {
+        fixed_errors(sc.n_data, cfg.xs, cfg.zs, cfg.ys, fx_, fz_);
+    }
+
+    ShotBatch sample(std::uint64_t n) {
+        // Two prefix copies, two Pauli strings and both rounds; the parity path touches no state.
+        [[maybe_unused]] const std::size_t shot_amps = prefix_
+            ? std::size_t(4 + z_round_passes(sc_) + x_round_passes(sc_)) << sc_.n_qubits() : 0;
+        ShotBatch b;
+        b.x_err.reserve(n); b.z_err.reserve(n); b.z_syn.reserve(n); b.x_syn.reserve(n);
+        for (std::uint64_t s = 0; s < n; ++s) {
+            QC_STATS_SCOPE("surface.shot", shot_amps);
+            ErrorBits xe = fx_, ze = fz_, nx = none_, nz = none_;
+            if (cfg_.p > 0.0) {
+                for (int q = 0; q < sc_.n_data; ++q) {
+                    if (!coin_(rng_)) continue;
+                    const int k = which_(rng_);
+                    if (k != 1) { xe[q] ^= 1; nx[q] = 1; }
+                    if (k != 0) { ze[q] ^= 1; nz[q] = 1; }
+                }
+            }
+            if (prefix_) {
+                copy_state(prefix_->z0, psi_);
+                apply_errors(psi_, nx, nz);
+                b.z_syn.push_back(z_round(psi_, sc_));
+                copy_state(prefix_->x0, psi_);
+                apply_errors(psi_, nx, nz);
+                b.x_syn.push_back(x_round(psi_, sc_));
+            } else {
+                b.z_syn.push_back(syndrome_of(sc_.z_checks, xe));
+                b.x_syn.push_back(syndrome_of(sc_.x_checks, ze));
+            }
+            b.x_err.push_back(std::move(xe));
+            b.z_err.push_back(std::move(ze));
+        }
+        return b;
+    }
+
+private:
+    static std::mt19937_64 make_rng(const PipelineConfig& cfg, unsigned worker) {
+        if (!cfg.have_seed) return std::mt19937_64(std::random_device{}());
+        std::seed_seq ss{cfg.seed, static_cast<std::uint64_t>(worker)};
+        return std::mt19937_64(ss);
+    }
+
+    const PipelineConfig& cfg_;
+    const SurfaceCode& sc_;
+    const RoundPrefix* prefix_;
+    std::mt19937_64 rng_;
+    std::bernoulli_distribution coin_;
+    std::uniform_int_distribution<int> which_{0, 2}; // 0:X,1:Z,2:Y
+    ErrorBits fx_, fz_;
+    const ErrorBits none_;
+    State psi_;   // reused across shots
+};
+
+Tally decode_batch(const CodeDecoder& dec, const ShotBatch& b) {
+    Tally t;
+    for (size_t s = 0; s < b.x_err.size(); ++s) {
+        const bool xf = dec.x_fails(b.x_err[s], b.z_syn[s]);
+        const bool zf = dec.z_fails(b.z_err[s], b.x_syn[s]);
+        ++t.shots;
+        t.x_failures += xf;
+        t.z_failures += zf;
+        t.failures   += (xf || zf);
+    }
+    return t;
+}
+
+void sim_worker(const PipelineConfig& cfg, const SurfaceCode& sc, const RoundPrefix* prefix,
+                unsigned worker, std::atomic<std::uint64_t>& next_shot,
+                const std::atomic<bool>& stop, BoundedQueue<ShotBatch>& out)
+{
+    ShotSampler sampler(cfg, sc, prefix, worker);
+    for (;;) {
+        if (stop.load(std::memory_order_relaxed)) break;
+        const std::uint64_t start = next_shot.fetch_add(cfg.batch, std::memory_order_relaxed);
+        if (start >= cfg.max_shots) break;
+        out.push(sampler.sample(std::min<std::uint64_t>(cfg.batch, cfg.max_shots - start)));
+    }
+}
+
+void decode_worker(const CodeDecoder& dec, BoundedQueue<ShotBatch>& in, BoundedQueue<Tally>& out) {
+    ShotBatch b;
+    while (in.pop(b)) out.push(decode_batch(dec, b));
+}
+
+void add_tally(PipelineResult& res, const Tally& t) {
+    res.shots      += t.shots;
+    res.failures   += t.failures;
+    res.x_failures += t.x_failures;
+    res.z_failures += t.z_failures;
+}
+
+} // namespace
+
+void fixed_errors(int n_data, const std::vector<int>& xs, const std::vector<int>& zs,
+                  const std::vector<int>& ys, ErrorBits& xe, ErrorBits& ze)
+{
+    xe.assign(n_data, 0);
+    ze.assign(n_data, 0);
+    for (int q : xs) xe[q] ^= 1;
+    for (int q : zs) ze[q] ^= 1;
+    for (int q : ys) { xe[q] ^= 1; ze[q] ^= 1; }
+}
+
+void apply_errors(State& psi, const ErrorBits& xe, const ErrorBits& ze) {
+    std::uint64_t xm = 0, zm = 0;
+    for (size_t q = 0; q < xe.size(); ++q) xm |= std::uint64_t(xe[q] & 1u) << q;
+    for (size_t q = 0; q < ze.size(); ++q) zm |= std::uint64_t(ze[q] & 1u) << q;
+    apply_pauli_string(psi, xm, zm);
+}
+
+RoundPrefix build_prefix(const SurfaceCode& sc, const std::vector<int>& xs,
+                         const std::vector<int>& zs, const std::vector<int>& ys)
+{
+    // basis + Pauli string for each run, plus the H pass per data qubit of the X run.
+    QC_STATS_SCOPE("surface.inject", (std::size_t(4) + sc.n_data) << sc.n_qubits());
+    ErrorBits fx, fz;
+    fixed_errors(sc.n_data, xs, zs, ys, fx, fz);
+    RoundPrefix prefix;
+    prefix.z0 = basis(sc.n_qubits(), 0);
+    apply_errors(prefix.z0, fx, fz);
+    prefix.x0 = basis(sc.n_qubits(), 0);
+    prepare_all_plus_unitary(prefix.x0, sc);   // deterministic |+>^n_data
+    apply_errors(prefix.x0, fx, fz);
+    return prefix;
+}
+
+PipelineResult run_pipeline(const PipelineConfig& cfg,
+                            const std::function<bool(const PipelineResult&)>& stop_when)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const SurfaceCode sc = build_rotated_surface_code(cfg.d);
+    const CodeDecoder dec(sc);
+
+    PipelineResult res;
+    res.state_vector = cfg.backend == PipelineConfig::Backend::StateVector ||
+                       (cfg.backend == PipelineConfig::Backend::Auto && sc.n_qubits() <= kMaxStateVectorQubits);
+
+    RoundPrefix prefix;
+    if (res.state_vector) prefix = build_prefix(sc, cfg.xs, cfg.zs, cfg.ys);
+    const RoundPrefix* prefix_ptr = res.state_vector ? &prefix : nullptr;
+
+    if (cfg.inline_stages) {
+        ShotSampler sampler(cfg, sc, prefix_ptr, 0);
+        for (std::uint64_t start = 0; start < cfg.max_shots; start += cfg.batch) {
+            const std::uint64_t n = std::min<std::uint64_t>(cfg.batch, cfg.max_shots - start);
+            add_tally(res, decode_batch(dec, sampler.sample(n)));
+            if (stop_when && stop_when(res)) break;
+        }
+        res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return res;
+    }
+
+    const int n_sim = std::max(1, cfg.sim_threads);
+    const int n_dec = std::max(1, cfg.decode_threads);
+    BoundedQueue<ShotBatch> syndromes(cfg.queue_batches);
+    BoundedQueue<Tally> tallies(cfg.queue_batches);
+    std::atomic<std::uint64_t> next_shot{0};
+    std::atomic<bool> stop{false};
+    std::atomic<int> sims_left{n_sim}, decs_left{n_dec};
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < n_sim; ++w) {
+        threads.emplace_back([&, w] {
+            sim_worker(cfg, sc, prefix_ptr, (unsigned)w, next_shot, stop, syndromes);
+            if (sims_left.fetch_sub(1, std::memory_order_acq_rel) == 1) syndromes.close();
+        });
+    }
+    for (int w = 0; w < n_dec; ++w) {
+        threads.emplace_back([&] {
+            decode_worker(dec, syndromes, tallies);
+            if (decs_left.fetch_sub(1, std::memory_order_acq_rel) == 1) tallies.close();
+        });
+    }
+
+    // aggregator (sleeps in pop() while the decoders are busy)
+    Tally t;
+    while (tallies.pop(t)) {
+        add_tally(res, t);
+        if (stop_when && !stop.load(std::memory_order_relaxed) && stop_when(res))
+            stop.store(true, std::memory_order_relaxed);
+    }
+    for (auto& th : threads) th.join();
+
+    res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+} // namespace qc::surface
@@ -0,0 +1,80 @@
+#pragma once
+#include "surface_code.h"
+#include "decoder.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace qc::surface {
+
+// simulate → decode → aggregate, each stage on its own threads, connected by bounded
+// lock-free queues of shot batches:
+//
+//   sim workers ──ShotBatch──▶ decode workers ──Tally──▶ aggregator (calling thread)
+//
+// Sim workers sample code-capacity errors (fixed injections + depolarizing p per data
+// qubit) and extract both syndromes; decoders match them and check the logical; the
+// aggregator sums failures. Full queues stall the upstream stage, so memory stays at
+// O(queue_batches × batch) shots however long the run.
+struct PipelineConfig {
+    int d = 3;
+    double p = 0.0;                     // depolarizing per data qubit (X/Y/Z equally)
+    std::vector<int> xs, zs, ys;        // fixed injections applied to every shot
+    std::uint64_t max_shots = 1000;
+    int sim_threads = 1;
+    int decode_threads = 1;
+    int batch = 64;                     // shots per queue item
+    std::size_t queue_batches = 64;     // capacity of each queue, in batches
+    bool have_seed = false;
+    std::uint64_t seed = 0;             // worker w uses seed_seq{seed, w}
+
+    // Simulate and decode batch by batch on the calling thread instead of on worker threads
+    // (sim_threads/decode_threads/queue_batches are ignored; shots come from worker 0's
+    // stream). For callers that already run one pipeline per core, like the sweep.
+    bool inline_stages = false;
+
+    // Syndromes from the state vector (z_round/x_round) when the patch fits, otherwise
+    // from check parities of the sampled error; both agree for this noise model.
+    enum class Backend { Auto, StateVector, Parity } backend = Backend::Auto;
+};
+
+struct PipelineResult {
+    std::uint64_t shots = 0;
+    std::uint64_t failures = 0;         // X or Z logical flipped
+    std::uint64_t x_failures = 0;
+    std::uint64_t z_failures = 0;
+    double seconds = 0.0;
+    bool state_vector = false;
+};
+
+// Largest patch run through the state vector under Backend::Auto (rotated d=3 has 17
+// qubits; d=5 has 49 and always takes the parity path).
+constexpr int kMaxStateVectorQubits = 20;
+
+// Deterministic start of both syndrome runs: everything before the first random draw.
+// Shared read-only by sim workers (and by qc_surface's round loop); each shot starts
+// from a copy.
+struct RoundPrefix {
+    State z0;   // |0...0>, fixed injections applied
+    State x0;   // |+>^n_data, fixed injections applied
+};
+
+// Fixed injections as per-data-qubit X/Z bits (Y sets both).
+void fixed_errors(int n_data, const std::vector<int>& xs, const std::vector<int>& zs,
+                  const std::vector<int>& ys, ErrorBits& xe, ErrorBits& ze);
+
+// Apply X^xe Z^ze to the data qubits in one apply_pauli_string sweep.
+void apply_errors(State& psi, const ErrorBits& xe, const ErrorBits& ze);
+
+// Build the prefix for sc; indices in xs/zs/ys must already be valid data qubits.
+RoundPrefix build_prefix(const SurfaceCode& sc, const std::vector<int>& xs,
+                         const std::vector<int>& zs, const std::vector<int>& ys);
+
+// Run the pipeline on a rotated patch of distance cfg.d. stop_when, if given, is checked by
+// the aggregator after every batch; once it returns true no new shots are started (batches
+// already in flight are still counted).
+PipelineResult run_pipeline(const PipelineConfig& cfg,
+                            const std::function<bool(const PipelineResult&)>& stop_when = {});
+
+} // namespace qc::surface
@@ -0,0 +1,102 @@
+#include "sweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ostream>
+#include <thread>
+
+namespace qc::surface {
+
+void wilson_interval(std::uint64_t k, std::uint64_t n, double z, double& lo, double& hi) {
+    if (n == 0) { lo = 0.0; hi = 1.0; return; }
+    const double nn = (double)n, ph = (double)k / nn, z2 = z * z;
+    const double den = 1.0 + z2 / nn;
+    const double mid = (ph + z2 / (2.0 * nn)) / den;
+    const double half = z * std::sqrt(ph * (1.0 - ph) / nn + z2 / (4.0 * nn * nn)) / den;
+    lo = std::max(0.0, mid - half);
+    hi = std::min(1.0, mid + half);
+}
+
+namespace {
+
+bool ci_converged(const SweepConfig& cfg, const PipelineResult& r) {
+    if (cfg.target_rel_ci <= 0.0 || r.failures == 0) return false;
+    double lo, hi;
+    wilson_interval(r.failures, r.shots, cfg.z, lo, hi);
+    const double pl = (double)r.failures / (double)r.shots;
+    return 0.5 * (hi - lo) <= cfg.target_rel_ci * pl;
+}
+
+SweepPoint run_point(const SweepConfig& cfg, int d, double p, std::size_t index) {
+    PipelineConfig pc;
+    pc.d = d;
+    pc.p = p;
+    pc.max_shots = cfg.max_shots;
+    pc.batch = cfg.batch;
+    // The sweep already runs one point per core; a point's stages run inline on its thread,
+    // which also stops it right after the batch that reaches its target.
+    pc.inline_stages = true;
+    pc.have_seed = cfg.have_seed;
+    pc.seed = cfg.seed ^ (0x9E3779B97F4A7C15ull * (index + 1));
+    pc.backend = cfg.backend;
+
+    SweepPoint pt;
+    pt.d = d;
+    pt.p = p;
+    pt.r = run_pipeline(pc, [&cfg](const PipelineResult& r) {
+        return (cfg.target_failures && r.failures >= cfg.target_failures) || ci_converged(cfg, r);
+    });
+    pt.p_L = pt.r.shots ? (double)pt.r.failures / (double)pt.r.shots : 0.0;
+    wilson_interval(pt.r.failures, pt.r.shots, cfg.z, pt.ci_lo, pt.ci_hi);
+    pt.stop = (cfg.target_failures && pt.r.failures >= cfg.target_failures) ? "failures"
+            : ci_converged(cfg, pt.r) ? "ci" : "max_shots";
+    return pt;
+}
+
+} // namespace
+
+std::vector<SweepPoint> run_sweep(const SweepConfig& cfg) {
+    std::vector<std::pair<int,double>> grid;
+    for (int d : cfg.ds) for (double p : cfg.ps) grid.push_back({d, p});
+    std::vector<SweepPoint> out(grid.size());
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned n_thr = std::min<unsigned>(cfg.threads > 0 ? (unsigned)cfg.threads : hw,
+                                              (unsigned)std::max<std::size_t>(1, grid.size()));
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < n_thr; ++t) {
+        pool.emplace_back([&] {
+            for (std::size_t i; (i = next.fetch_add(1)) < grid.size(); )
+                out[i] = run_point(cfg, grid[i].first, grid[i].second, i);
+        });
+    }
+    for (auto& th : pool) th.join();
+    return out;
+}
+
+void write_sweep_csv(std::ostream& os, const std::vector<SweepPoint>& pts) {
+    os << "d,p,shots,failures,x_failures,z_failures,p_L,ci_lo,ci_hi,stop,seconds\n";
+    for (const auto& pt : pts) {
+        os << pt.d << "," << pt.p << "," << pt.r.shots << "," << pt.r.failures << ","
+           << pt.r.x_failures << "," << pt.r.z_failures << "," << pt.p_L << ","
+           << pt.ci_lo << "," << pt.ci_hi << "," << pt.stop << "," << pt.r.seconds << "\n";
+    }
+}
+
+void write_sweep_json(std::ostream& os, const std::vector<SweepPoint>& pts) {
+    os << "[\n";
+    for (std::size_t i = 0; i < pts.size(); ++i) {
+        const auto& pt = pts[i];
+        os << "  {\"d\":" << pt.d << ",\"p\":" << pt.p << ",\"shots\":" << pt.r.shots
+           << ",\"failures\":" << pt.r.failures << ",\"x_failures\":" << pt.r.x_failures
+           << ",\"z_failures\":" << pt.r.z_failures << ",\"p_L\":" << pt.p_L
+           << ",\"ci_lo\":" << pt.ci_lo << ",\"ci_hi\":" << pt.ci_hi
+           << ",\"stop\":\"" << pt.stop << "\",\"seconds\":" << pt.r.seconds << "}"
+           << (i + 1 < pts.size() ? ",\n" : "\n");
+    }
+    os << "]\n";
+}
+
+} // namespace qc::surface
@@ -0,0 +1,48 @@
+#pragma once
+#include "surface_pipeline.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace qc::surface {
+
+// Threshold sweep: every (d, p) point runs as its own single-threaded pipeline
+// (PipelineConfig::inline_stages), points in parallel, one per sweep thread. A point
+// stops as soon as it has target_failures logical failures, or once the Wilson interval of
+// p_L is within target_rel_ci of p_L, or at max_shots — whichever comes first — so
+// converged points stop consuming shots.
+struct SweepConfig {
+    std::vector<int> ds;
+    std::vector<double> ps;
+    std::uint64_t max_shots = 1000000;
+    std::uint64_t target_failures = 100;   // 0 = off
+    double target_rel_ci = 0.0;            // Wilson half-width / p_L; 0 = off
+    double z = 1.96;                       // confidence for the interval (95%)
+    int threads = 0;                       // points run concurrently; 0 = hardware threads
+    int batch = 256;
+    bool have_seed = false;
+    std::uint64_t seed = 0;                // point i uses a seed derived from (seed, i)
+    // Check parities by default: a threshold point needs ~1e5-1e6 shots and the state
+    // vector gives the same syndromes for this noise model at a far higher cost.
+    PipelineConfig::Backend backend = PipelineConfig::Backend::Parity;
+};
+
+struct SweepPoint {
+    int d = 0;
+    double p = 0.0;
+    PipelineResult r;
+    double p_L = 0.0, ci_lo = 0.0, ci_hi = 0.0;
+    const char* stop = "";                 // "failures", "ci" or "max_shots"
+};
+
+// Wilson score interval for k successes in n trials.
+void wilson_interval(std::uint64_t k, std::uint64_t n, double z, double& lo, double& hi);
+
+// Points come back in (d-major, p-minor) order regardless of completion order.
+std::vector<SweepPoint> run_sweep(const SweepConfig& cfg);
+
+void write_sweep_csv(std::ostream& os, const std::vector<SweepPoint>& pts);
+void write_sweep_json(std::ostream& os, const std::vector<SweepPoint>& pts);
+
+} // namespace qc::surface
@@ -1,9 +1,12 @@
 #include "qc.h"
+#include "parallel.h"
 
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <stdexcept>
 
 namespace qc{
 
@@ -27,8 +30,73 @@ static double phase_arg(const C& z) {
     return std::atan2(z.imag(), z.real()); // [-pi, pi]
 }
 
+namespace {
+
+struct Term { std::uint64_t idx; double prob; };
+
+// Larger probability first; equal probabilities in index order.
+inline bool term_before(const Term& x, const Term& y) {
+    return x.prob > y.prob || (x.prob == y.prob && x.idx < y.idx);
+}
+
+constexpr std::size_t kScanChunk = 1ull << 16;
+
+struct TopTerms {
+    std::vector<Term> terms;   // prob holds |a|² (unnormalized) until the caller rescales
+    double s2 = 0.0;           // Σ|a|²
+};
+
+// One parallel pass: Σ|a|² plus the candidate terms, sorted by term_before. With k > 0 only
+// the top k are kept: each worker streams its chunk through a bounded min-heap, so memory is
+// O(k · workers) instead of a copy of the whole state. The cutoff is relative to Σ|a|², which
+// is only known at the end; a term below cutoff × (the worker's running sum) is already below
+// cutoff × Σ|a|² and is dropped early, the rest are filtered once the sum is known.
+TopTerms top_terms(const State& psi, double cutoff, std::size_t k) {
+    const std::size_t N = psi.size();
+    const unsigned workers = parallel_workers(N, kScanChunk);
+    std::vector<std::vector<Term>> part(workers);
+    std::vector<double> part_s2(workers, 0.0);
+    parallel_for(N, kScanChunk, [&](std::size_t b, std::size_t e, unsigned w) {
+        auto& h = part[w];
+        if (k) h.reserve(k);
+        double acc = part_s2[w];
+        for (std::size_t i = b; i < e; ++i) {
+            const double p = std::norm(psi[i]);
+            acc += p;
+            if (p < cutoff * acc) continue;
+            const Term t{i, p};
+            if (!k) { h.push_back(t); continue; }
+            if (h.size() < k) {
+                h.push_back(t);
+                std::push_heap(h.begin(), h.end(), term_before);   // front = weakest kept
+            } else if (term_before(t, h.front())) {
+                std::pop_heap(h.begin(), h.end(), term_before);
+                h.back() = t;
+                std::push_heap(h.begin(), h.end(), term_before);
+            }
+        }
+        part_s2[w] = acc;
+    });
+
+    TopTerms r;
+    for (double v : part_s2) r.s2 += v;
+    const double keep = cutoff * r.s2;
+    for (auto& h : part)
+        for (const Term& t : h)
+            if (t.prob >= keep) r.terms.push_back(t);
+    auto& all = r.terms;
+    if (k && all.size() > k) {
+        std::nth_element(all.begin(), all.begin() + (k - 1), all.end(), term_before);
+        all.resize(k);
+    }
+    std::sort(all.begin(), all.end(), term_before);
+    return r;
+}
+
+} // namespace
+
 // 状態 |ψ> を読みやすく出力。確率降順に並べ、しきい値以下は省略。
-// max_terms>0 なら上位 max_terms のみ表示。
+// max_terms>0 なら上位 max_terms のみ表示（ストリーミング top-k: 全振幅のコピーやソートはしない）。
 // show_prob: 確率も表示、show_phase: 位相（ラジアン）も表示。
 void pretty_print(const State& psi,
                   int n_qubits,
@@ -38,29 +106,17 @@ void pretty_print(const State& psi,
                   bool show_prob = true,
                   bool show_phase = false)
 {
-    // 規格化チェック（軽く補正）
-    double s = 0.0;
-    for (auto& a : psi) s += std::norm(a);
-    if (s == 0.0) {
+    // ノルムと上位項を 1 パスで集める（規格化は最後に軽く補正）
+    auto top = top_terms(psi, cutoff, max_terms > 0 ? static_cast<std::size_t>(max_terms) : 0);
+    const double s2 = top.s2;
+    if (s2 == 0.0) {
         std::cout << "|ψ> = (all zero)\n";
         return;
     }
-    s = std::sqrt(s);
-
-    struct Item { std::uint64_t idx; C amp; double prob; };
-    std::vector<Item> items; items.reserve(psi.size());
-    for (std::uint64_t i=0; i<psi.size(); ++i) {
-        C a = psi[i] / s;               // 軽く正規化
-        double p = std::norm(a);
-        if (p >= cutoff) items.push_back({i, a, p});
-    }
-
-    // 確率降順
-    std::sort(items.begin(), items.end(),
-              [](const Item& x, const Item& y){ return x.prob > y.prob; });
-
-    if (max_terms > 0 && (int)items.size() > max_terms)
-        items.resize(max_terms);
+    const double s = std::sqrt(s2);
+    const double inv_s2 = 1.0 / s2;
+    auto& items = top.terms;
+    for (auto& it : items) it.prob *= inv_s2;
 
     // 見出し
     std::cout << "|ψ> (n=" << n_qubits << " qubits)  nonzero terms: "
@@ -70,13 +126,56 @@ void pretty_print(const State& psi,
     // 本体
     std::cout.setf(std::ios::fixed); std::cout << std::setprecision(precision);
     for (auto& it : items) {
+        const C amp = psi[it.idx] / s;  // 軽く正規化
         std::string ket = bitstr(it.idx, n_qubits);
         std::cout << "  |" << ket << ">  "
-                  << "amp=" << fmt_complex(it.amp, precision);
+                  << "amp=" << fmt_complex(amp, precision);
         if (show_prob)  std::cout << "  P=" << it.prob;
-        if (show_phase) std::cout << "  phase=" << phase_arg(it.amp);
+        if (show_phase) std::cout << "  phase=" << phase_arg(amp);
         std::cout << "\n";
     }
 }
 
+// 確率 |a_i|²/Σ|a|² を float64 の生配列（ホストのバイト順, index 昇順）として書き出す。
+// numpy.fromfile(path, dtype=float64) でそのまま読める。状態は 1 パスだけ読む: |a|² を
+// チャンク単位で書きながら Σ|a|² を集め、規格化されていない状態のときだけ最後にファイル側を
+// 読み戻してスケールする（シミュレータの状態は通常規格化済みなので追加パスは起きない）。
+void export_probabilities(const State& psi, const std::string& path) {
+    std::fstream fs(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    if (!fs) throw std::runtime_error("export_probabilities " + path + ": cannot open for writing");
+
+    constexpr std::size_t kOutChunk = 1ull << 22;   // 32 MiB of doubles per write
+    constexpr double kNormTol = 1e-13;              // |Σ|a|² - 1| below this: leave as is
+    std::vector<double> buf(std::min(psi.size(), kOutChunk));
+    std::vector<double> part(parallel_workers(std::min(psi.size(), kOutChunk), kScanChunk));
+    double s2 = 0.0;
+    for (std::size_t base = 0; base < psi.size(); base += kOutChunk) {
+        const std::size_t n = std::min(kOutChunk, psi.size() - base);
+        std::fill(part.begin(), part.end(), 0.0);
+        parallel_for(n, kScanChunk, [&](std::size_t b, std::size_t e, unsigned w) {
+            double acc = 0.0;
+            for (std::size_t i = b; i < e; ++i) acc += (buf[i] = std::norm(psi[base + i]));
+            part[w] += acc;
+        });
+        for (double v : part) s2 += v;
+        fs.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(n * sizeof(double)));
+    }
+    if (!fs) throw std::runtime_error("export_probabilities " + path + ": write failed");
+
+    if (s2 > 0.0 && std::abs(s2 - 1.0) > kNormTol) {
+        const double inv = 1.0 / s2;
+        for (std::size_t base = 0; base < psi.size(); base += kOutChunk) {
+            const std::size_t n = std::min(kOutChunk, psi.size() - base);
+            const auto off = static_cast<std::streamoff>(base * sizeof(double));
+            const auto bytes = static_cast<std::streamsize>(n * sizeof(double));
+            fs.seekg(off);
+            fs.read(reinterpret_cast<char*>(buf.data()), bytes);
+            for (std::size_t i = 0; i < n; ++i) buf[i] *= inv;
+            fs.seekp(off);
+            fs.write(reinterpret_cast<const char*>(buf.data()), bytes);
+        }
+        if (!fs) throw std::runtime_error("export_probabilities " + path + ": write failed");
+    }
+}
+
 }
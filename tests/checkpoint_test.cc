@@ -0,0 +1,113 @@
+// tests/checkpoint_test.cc
+#include "qc.h"
+#include "checkpoint.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using namespace qc;
+
+namespace {
+State ramp_state(int n) {
+    State psi(1u << n);
+    for (size_t i = 0; i < psi.size(); ++i)
+        psi[i] = C{std::cos(0.11 * i), std::sin(0.29 * i + 0.5)};
+    renormalize(psi);
+    return psi;
+}
+
+std::string tmp_path(const char* name) { return ::testing::TempDir() + name; }
+} // namespace
+
+TEST(Checkpoint, SaveLoadRoundTripIsBitExact) {
+    const State psi = ramp_state(10);
+    const auto path = tmp_path("qc_ckpt_roundtrip.qcs");
+    save_state(psi, path);
+
+    State back = load_state(path);
+    ASSERT_EQ(back.size(), psi.size());
+    for (size_t i = 0; i < psi.size(); ++i) EXPECT_EQ(back[i], psi[i]) << "i=" << i;
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, OverwriteReplacesFileWithoutLeavingTemp) {
+    const auto path = tmp_path("qc_ckpt_overwrite.qcs");
+    save_state(ramp_state(6), path);
+    const State psi = ramp_state(4);
+    save_state(psi, path);
+
+    const State back = load_state(path);
+    ASSERT_EQ(back.size(), psi.size());
+    for (size_t i = 0; i < psi.size(); ++i) EXPECT_EQ(back[i], psi[i]) << "i=" << i;
+    EXPECT_FALSE(std::ifstream(path + ".tmp").good());
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, MappedViewSharesFileContents) {
+    const State psi = ramp_state(9);
+    const auto path = tmp_path("qc_ckpt_mmap.qcs");
+    save_state(psi, path);
+
+    MappedState m(path, /*verify=*/true);
+    EXPECT_EQ(m.n_qubits(), 9);
+    ASSERT_EQ(m.size(), psi.size());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(m.data()) % alignof(C), 0u);
+    for (size_t i = 0; i < psi.size(); ++i) EXPECT_EQ(m.data()[i], psi[i]) << "i=" << i;
+
+    State copy = m.to_state();
+    copy[0] = C{0,0};                       // private copy; the mapping is untouched
+    EXPECT_EQ(m.data()[0], psi[0]);
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, CorruptPayloadFailsChecksum) {
+    const State psi = ramp_state(6);
+    const auto path = tmp_path("qc_ckpt_corrupt.qcs");
+    save_state(psi, path);
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(kStateHeaderBytes + 17);
+        f.put('\x5a');
+    }
+    EXPECT_THROW(load_state(path), std::runtime_error);
+    EXPECT_NO_THROW(load_state(path, /*verify=*/false));
+    EXPECT_THROW(MappedState(path, /*verify=*/true), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, RejectsForeignFile) {
+    const auto path = tmp_path("qc_ckpt_foreign.qcs");
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << std::string(kStateHeaderBytes + 64, 'x');
+    }
+    EXPECT_THROW(load_state(path), std::runtime_error);
+    EXPECT_THROW(load_state(tmp_path("qc_ckpt_missing.qcs")), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, RejectsOversizedHeaderWithoutAllocating) {
+    const auto path = tmp_path("qc_ckpt_huge.qcs");
+    save_state(ramp_state(2), path);
+    std::string head(kStateHeaderBytes, '\0');
+    {
+        std::ifstream f(path, std::ios::binary);
+        f.read(&head[0], kStateHeaderBytes);
+    }
+    StateFileHeader h;
+    std::memcpy(&h, head.data(), sizeof(h));
+    h.n_qubits = 60;
+    h.n_amps   = 1ull << 60;
+    std::memcpy(&head[0], &h, sizeof(h));
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f << head;
+    }
+    EXPECT_THROW(load_state(path), std::runtime_error);
+    EXPECT_THROW(MappedState(path, /*verify=*/false), std::runtime_error);
+    std::remove(path.c_str());
+}
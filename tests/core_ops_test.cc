@@ -4,6 +4,7 @@
 #include <array>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 using namespace qc;
 
@@ -114,3 +115,105 @@ TEST(CoreOps, Apply2Q_CreateBell) {
     std::vector<C> ref = { C{s,0}, C{0,0}, C{0,0}, C{s,0} };
     expect_state_eq(psi, ref, 1e-12);
 }
+
+// ---------- specialized low-target kernels vs. reference ----------
+namespace {
+State ramp_state(int n) {
+    State psi(1u << n);
+    for (size_t i = 0; i < psi.size(); ++i)
+        psi[i] = C{std::cos(0.21 * i + 0.4), std::sin(0.53 * i)};
+    return psi;
+}
+} // namespace
+
+TEST(CoreOps, Apply1Q_AllTargetsMatchReference) {
+    const int n = 8;
+    const C U[2][2] = {{C{0.6,0.1}, C{-0.2,0.7}}, {C{0.3,-0.4}, C{0.5,0.5}}};
+    for (int t = 0; t < n; ++t) {
+        State psi = ramp_state(n);
+        State ref = psi;
+        for (size_t i = 0; i < ref.size(); ++i) {
+            if (i & (1ull << t)) continue;
+            const size_t j = i | (1ull << t);
+            const C a = psi[i], b = psi[j];
+            ref[i] = U[0][0]*a + U[0][1]*b;
+            ref[j] = U[1][0]*a + U[1][1]*b;
+        }
+        apply_1q(U, psi, t);
+        expect_state_eq(psi, ref);
+    }
+}
+
+TEST(CoreOps, Apply2Q_AllPairsMatchReference) {
+    const int n = 7;
+    C U4[4][4];
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c) U4[r][c] = C{0.1 * (r + 1) - 0.05 * c, 0.03 * r * c - 0.1};
+    for (int qa = 0; qa < n; ++qa) {
+        for (int qb = 0; qb < n; ++qb) {
+            if (qa == qb) continue;
+            const int lo = std::min(qa, qb), hi = std::max(qa, qb);
+            State psi = ramp_state(n);
+            State ref = psi;
+            for (size_t i = 0; i < ref.size(); ++i) {
+                if (i & ((1ull << lo) | (1ull << hi))) continue;
+                const size_t idx[4] = {i, i | (1ull << lo), i | (1ull << hi), i | (1ull << lo) | (1ull << hi)};
+                for (int r = 0; r < 4; ++r) {
+                    C acc{0,0};
+                    for (int c = 0; c < 4; ++c) acc += U4[r][c] * psi[idx[c]];
+                    ref[idx[r]] = acc;
+                }
+            }
+            apply_2q(U4, psi, qa, qb);
+            expect_state_eq(psi, ref);
+        }
+    }
+}
+
+// ---------- copy_state / fork ----------
+TEST(CoreOps, ForkIsIndependentAndCopyReusesBuffer) {
+    State psi = basis(5, 3);
+    State branch = fork(psi);
+    C X[2][2]; gate_X(X);
+    apply_1q(X, branch, 4);                 // evolving the branch leaves psi alone
+    expect_state_eq(psi, basis(5, 3));
+
+    State buf = basis(5, 0);
+    const C* before = buf.data();
+    copy_state(branch, buf);
+    EXPECT_EQ(buf.data(), before);
+    expect_state_eq(buf, branch);
+}
+
+TEST(CoreOps, CopyStateLargeParallel) {
+    State psi(1u << 20);
+    for (size_t i = 0; i < psi.size(); ++i) psi[i] = C{double(i), -double(i)};
+    State dst;
+    copy_state(psi, dst);
+    ASSERT_EQ(dst.size(), psi.size());
+    EXPECT_TRUE(dst == psi);
+}
+
+// ---------- apply_pauli_string ----------
+TEST(CoreOps, PauliStringMatchesSingleQubitGates) {
+    const int n = 5;
+    const C X[2][2] = {{C{0,0}, C{1,0}}, {C{1,0}, C{0,0}}};
+    const C Y[2][2] = {{C{0,0}, C{0,-1}}, {C{0,1}, C{0,0}}};
+    const C Z[2][2] = {{C{1,0}, C{0,0}}, {C{0,0}, C{-1,0}}};
+    const std::uint64_t masks[][2] = {
+        {0b00000, 0b00000}, {0b00100, 0b00000}, {0b00000, 0b10010},
+        {0b01000, 0b01000}, {0b10110, 0b01011}, {0b11111, 0b11111},
+    };
+    for (const auto& m : masks) {
+        State psi = ramp_state(n);
+        State ref = psi;
+        for (int q = 0; q < n; ++q) {
+            const bool x = (m[0] >> q) & 1u, z = (m[1] >> q) & 1u;
+            if (x && z) apply_1q(Y, ref, q);
+            else if (x) apply_1q(X, ref, q);
+            else if (z) apply_1q(Z, ref, q);
+        }
+        apply_pauli_string(psi, m[0], m[1]);
+        expect_state_eq(psi, ref);
+    }
+}
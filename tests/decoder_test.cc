@@ -0,0 +1,56 @@
+// tests/decoder_test.cc
+#include "surface_code.h"
+#include "decoder.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace qc::surface;
+
+TEST(MatchingDecoder, CorrectsEverySingleError) {
+    for (int d : {3, 5, 7}) {
+        auto sc = build_rotated_surface_code(d);
+        CodeDecoder dec(sc);
+        for (int q = 0; q < sc.n_data; ++q) {
+            ErrorBits e(sc.n_data, 0);
+            e[q] = 1;
+            EXPECT_FALSE(dec.x_fails(e, syndrome_of(sc.z_checks, e))) << "d=" << d << " X@" << q;
+            EXPECT_FALSE(dec.z_fails(e, syndrome_of(sc.x_checks, e))) << "d=" << d << " Z@" << q;
+        }
+    }
+}
+
+TEST(MatchingDecoder, CorrectsEveryWeightTwoErrorAtD5) {
+    auto sc = build_rotated_surface_code(5);
+    CodeDecoder dec(sc);
+    for (int a = 0; a < sc.n_data; ++a) {
+        for (int b = a + 1; b < sc.n_data; ++b) {
+            ErrorBits e(sc.n_data, 0);
+            e[a] = e[b] = 1;
+            EXPECT_FALSE(dec.x_fails(e, syndrome_of(sc.z_checks, e))) << "X@" << a << "," << b;
+            EXPECT_FALSE(dec.z_fails(e, syndrome_of(sc.x_checks, e))) << "Z@" << a << "," << b;
+        }
+    }
+}
+
+TEST(MatchingDecoder, CorrectionReproducesSyndrome) {
+    auto sc = build_rotated_surface_code(7);
+    MatchingDecoder dec(sc.n_data, sc.z_checks);
+    // many defects: exercises both the exact DP and the greedy fallback
+    for (int stride : {3, 2}) {
+        ErrorBits e(sc.n_data, 0);
+        for (int q = 0; q < sc.n_data; q += stride) e[q] = 1;
+        const auto syn = syndrome_of(sc.z_checks, e);
+        EXPECT_EQ(syndrome_of(sc.z_checks, dec.decode(syn)), syn) << "stride=" << stride;
+    }
+}
+
+TEST(MatchingDecoder, LogicalOperatorIsAFailure) {
+    auto sc = build_rotated_surface_code(5);
+    CodeDecoder dec(sc);
+    ErrorBits xl(sc.n_data, 0), zl(sc.n_data, 0);
+    for (int q : sc.logical_x) xl[q] = 1;
+    for (int q : sc.logical_z) zl[q] = 1;
+    EXPECT_EQ(syndrome_of(sc.z_checks, xl), std::vector<int>(sc.z_checks.size(), 0));
+    EXPECT_TRUE(dec.x_fails(xl, syndrome_of(sc.z_checks, xl)));
+    EXPECT_TRUE(dec.z_fails(zl, syndrome_of(sc.x_checks, zl)));
+}
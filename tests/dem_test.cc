@@ -0,0 +1,111 @@
+// tests/dem_test.cc
+#include "dem.h"
+#include "decoder.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace qc::surface;
+
+namespace {
+
+const DemError* find_error(const DetectorErrorModel& dem, const std::vector<int>& dets, bool obs) {
+    for (const auto& e : dem.errors)
+        if (e.detectors == dets && e.observable == obs) return &e;
+    return nullptr;
+}
+
+} // namespace
+
+TEST(Dem, NoNoiseNoErrors) {
+    const auto sc = build_rotated_surface_code(3);
+    DemConfig cfg;
+    cfg.rounds = 2;
+    const auto dem = extract_dem(sc, cfg);
+    EXPECT_TRUE(dem.errors.empty());
+    // Z basis: round 0 has only Z detectors, round 1 both, plus the final Z checks.
+    EXPECT_EQ(dem.detector_coords.size(), 4u + 8u + 4u);
+    EXPECT_TRUE(dem.has_observable);
+}
+
+TEST(Dem, DataNoiseMatchesCheckParities) {
+    const auto sc = build_rotated_surface_code(3);
+    DemConfig cfg;
+    cfg.rounds = 1;
+    cfg.p_data = 0.03;
+    const auto dem = extract_dem(sc, cfg);
+
+    // One round, Z basis: X and Y on q both fire the Z checks containing q (Z alone is
+    // invisible), and L0 iff q lies on the Z_L row. Detectors 0..3 are the round-0 Z checks.
+    // Qubits with the same symptom are merged into one error.
+    const double p1 = 2 * (cfg.p_data / 3) * (1 - cfg.p_data / 3);
+    std::map<std::pair<std::vector<int>, bool>, double> want;
+    for (int q = 0; q < sc.n_data; ++q) {
+        ErrorBits e(sc.n_data, 0);
+        e[q] = 1;
+        const auto syn = syndrome_of(sc.z_checks, e);
+        std::vector<int> dets;
+        for (size_t k = 0; k < syn.size(); ++k) if (syn[k]) dets.push_back((int)k);
+        const bool obs = std::count(sc.logical_z.begin(), sc.logical_z.end(), q) > 0;
+        double& p = want[{dets, obs}];
+        p = p + p1 - 2 * p * p1;
+    }
+    EXPECT_EQ(dem.errors.size(), want.size());
+    for (const auto& [key, p] : want) {
+        const DemError* err = find_error(dem, key.first, key.second);
+        ASSERT_NE(err, nullptr);
+        EXPECT_NEAR(err->p, p, 1e-15);
+    }
+}
+
+TEST(Dem, MeasurementErrorsAreTimelike) {
+    const auto sc = build_rotated_surface_code(3);
+    DemConfig cfg;
+    cfg.rounds = 3;
+    cfg.p_meas = 0.01;
+    const auto dem = extract_dem(sc, cfg);
+    // A flipped ancilla readout fires the same check in two consecutive rounds.
+    const int per_round = (int)(sc.z_checks.size() + sc.x_checks.size());
+    const int z0 = (int)sc.z_checks.size();          // first detector of round 1
+    EXPECT_NE(find_error(dem, {0, z0}, false), nullptr);
+    EXPECT_NE(find_error(dem, {z0, z0 + per_round}, false), nullptr);
+    for (const auto& e : dem.errors) {
+        EXPECT_GE(e.detectors.size(), 1u);
+        EXPECT_LE(e.detectors.size(), 2u);
+    }
+}
+
+TEST(Dem, CircuitNoiseNeverFlipsLogicalSilently) {
+    // Distance 3 with hook-safe schedules: no single fault flips L0 without a detector.
+    for (bool xb : {false, true}) {
+        const auto sc = build_rotated_surface_code(3);
+        DemConfig cfg;
+        cfg.rounds = 2;
+        cfg.x_basis = xb;
+        cfg.p_data = cfg.p_cnot = cfg.p_meas = cfg.p_reset = 0.001;
+        const auto dem = extract_dem(sc, cfg);
+        EXPECT_FALSE(dem.errors.empty());
+        for (const auto& e : dem.errors) {
+            EXPECT_FALSE(e.detectors.empty());
+            EXPECT_GT(e.p, 0.0);
+            for (int det : e.detectors) EXPECT_LT(det, (int)dem.detector_coords.size());
+        }
+    }
+}
+
+TEST(Dem, WritesStimStyleText) {
+    const auto sc = build_rotated_surface_code(3);
+    DemConfig cfg;
+    cfg.rounds = 1;
+    cfg.p_data = 0.03;
+    const auto dem = extract_dem(sc, cfg);
+    std::ostringstream os;
+    write_dem(os, dem);
+    const std::string s = os.str();
+    EXPECT_EQ(s.rfind("error(", 0), 0u);
+    EXPECT_NE(s.find("detector("), std::string::npos);
+    EXPECT_NE(s.find(" L0\n"), std::string::npos);
+    EXPECT_NE(s.find("logical_observable L0\n"), std::string::npos);
+}
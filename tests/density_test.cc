@@ -0,0 +1,164 @@
+// tests/density_test.cc
+#include "density.h"
+#include "surface_exact.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace qc;
+
+namespace {
+
+void expect_rho_eq(const DensityMatrix& a, const DensityMatrix& b, double eps = 1e-12) {
+    ASSERT_EQ(a.n, b.n);
+    ASSERT_EQ(a.rho.size(), b.rho.size());
+    for (size_t i = 0; i < a.rho.size(); ++i) {
+        EXPECT_NEAR(a.rho[i].real(), b.rho[i].real(), eps) << "i=" << i;
+        EXPECT_NEAR(a.rho[i].imag(), b.rho[i].imag(), eps) << "i=" << i;
+    }
+}
+
+State sample_state3() {
+    State psi = {C{0.3,0.1}, C{-0.2,0.4}, C{0.5,0}, C{0.1,-0.3},
+                 C{0,0.2}, C{0.25,0.25}, C{-0.1,0}, C{0.35,-0.05}};
+    renormalize(psi);
+    return psi;
+}
+
+// ρ accumulated as Σ w · |ψ><ψ|
+void add_outer(DensityMatrix& acc, const State& psi, double w) {
+    const auto d = density_from_state(psi);
+    for (size_t i = 0; i < acc.rho.size(); ++i) acc.rho[i] += w * d.rho[i];
+}
+
+} // namespace
+
+TEST(Density, BasisAndTrace) {
+    const auto rho = density_basis(3, 5);
+    EXPECT_EQ(rho.n, 3);
+    EXPECT_EQ(rho.rho.size(), 64u);
+    EXPECT_DOUBLE_EQ(trace(rho), 1.0);
+    EXPECT_DOUBLE_EQ(diagonal(rho)[5], 1.0);
+}
+
+TEST(Density, GatesMatchStateVectorOuterProduct) {
+    State psi = sample_state3();
+    DensityMatrix rho = density_from_state(psi);
+
+    C H[2][2]; gate_H(H);
+    C Rz[2][2]; gate_Rz(Rz, 0.7);
+    C CX[4][4]; gate_CNOT(CX);
+    C X[2][2]; gate_X(X);
+
+    apply_1q(H, psi, 1);          apply_1q(H, rho, 1);
+    apply_1q(Rz, psi, 2);         apply_1q(Rz, rho, 2);
+    apply_2q(CX, psi, 0, 2);      apply_2q(CX, rho, 0, 2);
+    apply_controlled_1q(X, psi, 2, 1); apply_controlled_1q(X, rho, 2, 1);
+    apply_cnot_layer(psi, {{1, 0}});   apply_cnot_layer(rho, {{1, 0}});
+
+    expect_rho_eq(rho, density_from_state(psi));
+    EXPECT_NEAR(trace(rho), 1.0, 1e-12);
+}
+
+TEST(Density, PauliChannelIsMixtureOfPaulis) {
+    const State psi = sample_state3();
+    const double px = 0.1, py = 0.05, pz = 0.2;
+    DensityMatrix rho = density_from_state(psi);
+    apply_pauli_channel(rho, 1, px, py, pz);
+
+    C X[2][2]; gate_X(X);
+    const C Z[2][2] = {{C{1,0}, C{0,0}}, {C{0,0}, C{-1,0}}};
+    DensityMatrix want;
+    want.n = 3;
+    want.rho.assign(64, C{0,0});
+    State t = psi;                         add_outer(want, t, 1 - px - py - pz);
+    t = psi; apply_1q(X, t, 1);            add_outer(want, t, px);
+    t = psi; apply_1q(X, t, 1); apply_1q(Z, t, 1); add_outer(want, t, py);   // Y up to phase
+    t = psi; apply_1q(Z, t, 1);            add_outer(want, t, pz);
+    expect_rho_eq(rho, want);
+}
+
+TEST(Density, KrausAmplitudeDamping) {
+    const double g = 0.3;
+    std::vector<Kraus1q> K(2);
+    K[0] = {{{C{1,0}, C{0,0}}, {C{0,0}, C{std::sqrt(1 - g),0}}}};
+    K[1] = {{{C{0,0}, C{std::sqrt(g),0}}, {C{0,0}, C{0,0}}}};
+
+    DensityMatrix rho = density_basis(2, 0b10);   // qubit 1 excited
+    apply_kraus_1q(K, rho, 1);
+    const auto p = diagonal(rho);
+    EXPECT_NEAR(p[0b00], g, 1e-12);
+    EXPECT_NEAR(p[0b10], 1 - g, 1e-12);
+    EXPECT_NEAR(trace(rho), 1.0, 1e-12);
+}
+
+TEST(Density, ProjectAndDephaseBellState) {
+    State bell = basis(2, 0);
+    C H[2][2]; gate_H(H);
+    C CX[4][4]; gate_CNOT(CX);
+    apply_1q(H, bell, 0);
+    apply_cnot_layer(bell, {{0, 1}});
+
+    DensityMatrix d = density_from_state(bell);
+    dephase_qubit_Z(d, 0);
+    EXPECT_NEAR(d.rho[(0b00 << 2) | 0b00].real(), 0.5, 1e-12);
+    EXPECT_NEAR(d.rho[(0b11 << 2) | 0b11].real(), 0.5, 1e-12);
+    EXPECT_NEAR(std::abs(d.rho[(0b00 << 2) | 0b11]), 0.0, 1e-12);
+    EXPECT_NEAR(trace(d), 1.0, 1e-12);
+
+    DensityMatrix post = density_from_state(bell);
+    EXPECT_NEAR(prob_zero(post, 1), 0.5, 1e-12);
+    EXPECT_NEAR(project_qubit_Z(post, 1, 1), 0.5, 1e-12);
+    expect_rho_eq(post, density_basis(2, 0b11));
+
+    DensityMatrix s = density_from_state(bell);
+    const int m = measure_qubit_Z(s, 0);
+    expect_rho_eq(s, density_basis(2, m ? 0b11 : 0b00));
+}
+
+TEST(DensitySurface, BulkSyndromeDistributionMatchesEnumeration) {
+    using namespace qc::surface;
+    const auto sc = build_surface_code(3);
+    const double p = 0.1;
+    const auto res = run_exact(sc, {}, {}, {}, p);
+    EXPECT_EQ(res.qubits, 11);
+    EXPECT_FALSE(res.have_logical);
+
+    // Each data qubit carries an X component (X or Y) with prob 2p/3, and likewise Z; the
+    // components are independent per family, so enumerate the 2^9 patterns directly.
+    const double q = 2 * p / 3;
+    auto expected = [&](const std::vector<std::vector<int>>& checks) {
+        std::vector<double> dist(1u << checks.size(), 0.0);
+        for (unsigned e = 0; e < (1u << sc.n_data); ++e) {
+            double w = 1.0;
+            for (int k = 0; k < sc.n_data; ++k) w *= ((e >> k) & 1u) ? q : 1 - q;
+            unsigned s = 0;
+            for (size_t c = 0; c < checks.size(); ++c) {
+                unsigned par = 0;
+                for (int k : checks[c]) par ^= (e >> k) & 1u;
+                s |= par << c;
+            }
+            dist[s] += w;
+        }
+        return dist;
+    };
+    const auto wz = expected(sc.z_checks);
+    const auto wx = expected(sc.x_checks);
+    ASSERT_EQ(res.z_dist.size(), wz.size());
+    ASSERT_EQ(res.x_dist.size(), wx.size());
+    for (size_t s = 0; s < wz.size(); ++s) EXPECT_NEAR(res.z_dist[s], wz[s], 1e-10) << "s=" << s;
+    for (size_t s = 0; s < wx.size(); ++s) EXPECT_NEAR(res.x_dist[s], wx[s], 1e-10) << "s=" << s;
+}
+
+TEST(DensitySurface, FixedInjectionGivesDeltaDistribution) {
+    using namespace qc::surface;
+    const auto sc = build_surface_code(3);
+    const auto res = run_exact(sc, /*xs=*/{4}, /*zs=*/{}, /*ys=*/{2}, 0.0);
+    // X on the centre fires both Z checks; Y on qubit 2 adds an X-check hit (face (0,1)).
+    EXPECT_NEAR(res.z_dist[0b11], 1.0, 1e-12);
+    EXPECT_NEAR(res.x_dist[0b01], 1.0, 1e-12);
+}
+
+TEST(DensitySurface, RejectsOversizedRegister) {
+    using namespace qc::surface;
+    EXPECT_THROW(run_exact(build_rotated_surface_code(5), {}, {}, {}, 0.1), std::runtime_error);
+}
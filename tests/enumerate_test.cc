@@ -0,0 +1,98 @@
+// tests/enumerate_test.cc
+#include "enumerate.h"
+#include "decoder.h"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace qc::surface;
+
+TEST(Enumerate, DistanceThreeCorrectsWeightOne) {
+    const auto r = enumerate_low_weight(3, 1);
+    ASSERT_EQ(r.failures.size(), 2u);
+    EXPECT_EQ(r.errors[0], 1u);
+    EXPECT_EQ(r.errors[1], 27u);
+    EXPECT_EQ(r.failures[0], 0u);
+    EXPECT_EQ(r.failures[1], 0u);
+}
+
+TEST(Enumerate, WeightTwoMatchesDirectDecoding) {
+    const auto sc = build_rotated_surface_code(3);
+    const CodeDecoder dec(sc);
+    const int n = sc.n_data;
+    std::uint64_t fail = 0, xf = 0, zf = 0, total = 0;
+    for (int a = 0; a < n; ++a)
+        for (int b = a + 1; b < n; ++b)
+            for (int pa = 1; pa <= 3; ++pa)            // 1:X 2:Z 3:Y
+                for (int pb = 1; pb <= 3; ++pb) {
+                    ErrorBits xe(n, 0), ze(n, 0);
+                    xe[a] = pa & 1; ze[a] = pa >> 1;
+                    xe[b] = pb & 1; ze[b] = pb >> 1;
+                    const bool x = dec.x_fails(xe, syndrome_of(sc.z_checks, xe));
+                    const bool z = dec.z_fails(ze, syndrome_of(sc.x_checks, ze));
+                    ++total; xf += x; zf += z; fail += (x || z);
+                }
+    const auto r = enumerate_low_weight(3, 2);
+    EXPECT_EQ(r.errors[2], total);
+    EXPECT_EQ(r.failures[2], fail);
+    EXPECT_EQ(r.x_failures[2], xf);
+    EXPECT_EQ(r.z_failures[2], zf);
+    EXPECT_GT(fail, 0u);
+}
+
+TEST(Enumerate, FullEnumerationIsExact) {
+    const auto r = enumerate_low_weight(3, 9);
+    EXPECT_EQ(r.errors[9], 19683u);                    // 3^9
+    const double p = 0.05;
+    EXPECT_NEAR(truncation_bound(r, p), 0.0, 1e-12);
+
+    // Reference: decode every one of the 4^9 single-round Pauli patterns and weight it by
+    // (p/3)^k (1-p)^(n-k) directly, independent of the subset ranking and the polynomial.
+    const auto sc = build_rotated_surface_code(3);
+    const CodeDecoder dec(sc);
+    const int n = sc.n_data;
+    double ref_fail = 0.0, ref_x = 0.0, ref_z = 0.0;
+    ErrorBits xe(n), ze(n);
+    for (std::uint32_t code = 0; code < (1u << (2 * n)); ++code) {   // 2 bits per qubit
+        int k = 0;
+        for (int q = 0; q < n; ++q) {
+            const unsigned pq = (code >> (2 * q)) & 3u;                // 0:I 1:X 2:Z 3:Y
+            xe[q] = pq & 1u; ze[q] = pq >> 1;
+            k += pq != 0;
+        }
+        const double w = std::pow(p / 3, k) * std::pow(1 - p, n - k);
+        const bool x = dec.x_fails(xe, syndrome_of(sc.z_checks, xe));
+        const bool z = dec.z_fails(ze, syndrome_of(sc.x_checks, ze));
+        ref_x += x * w; ref_z += z * w; ref_fail += (x || z) * w;
+    }
+
+    double px = 0.0, pz = 0.0;
+    for (int k = 0; k <= r.max_weight; ++k) {
+        const double w = std::pow(p / 3, k) * std::pow(1 - p, r.n_data - k);
+        px += (double)r.x_failures[k] * w;
+        pz += (double)r.z_failures[k] * w;
+    }
+    EXPECT_NEAR(px, ref_x, 1e-12);
+    EXPECT_NEAR(pz, ref_z, 1e-12);
+    EXPECT_NEAR(failure_polynomial(r, p), ref_fail, 1e-12);
+    EXPECT_GT(failure_polynomial(r, p), px);
+    EXPECT_LT(failure_polynomial(r, p), 2 * px);
+}
+
+TEST(Enumerate, DistanceFiveCorrectsWeightTwo) {
+    // C(25,2) = 300 subsets, enough for several rank chunks on multi-core machines.
+    const auto r = enumerate_low_weight(5, 2);
+    EXPECT_EQ(r.errors[2], 300u * 9u);
+    EXPECT_EQ(r.failures[1], 0u);
+    EXPECT_EQ(r.failures[2], 0u);
+}
+
+TEST(Enumerate, UnrankAgreesWithColexStepping) {
+    const int n = 8, k = 3;
+    std::vector<int> c = unrank_subset(0, k, n);
+    EXPECT_EQ(c, (std::vector<int>{0, 1, 2}));
+    for (std::uint64_t rank = 1; rank < 56; ++rank) {      // C(8,3) = 56
+        next_subset_colex(c);
+        EXPECT_EQ(c, unrank_subset(rank, k, n)) << "rank=" << rank;
+    }
+    EXPECT_EQ(c, (std::vector<int>{5, 6, 7}));
+}
@@ -130,3 +130,26 @@ TEST(Controlled1Q, ControlledH_ActsOnlyWhenControlOne) {
         expect_state_eq(psi, ref);
     }
 }
+
+// ------------------------------------------------------------
+// apply_cnot_layer
+// ------------------------------------------------------------
+
+// 1 パスのレイヤ適用が apply_controlled_1q の逐次適用と一致すること
+TEST(CnotLayer, MatchesSequentialControlledX) {
+    const int n = 6;
+    State psi(1u << n);
+    for (size_t i = 0; i < psi.size(); ++i)
+        psi[i] = C{std::cos(0.3 * i), std::sin(0.7 * i + 0.1)};
+    renormalize(psi);
+
+    // controls {0,2,5}, targets {1,3,4}; target 4 is hit twice
+    const std::vector<std::pair<int,int>> layer = {{0,1}, {2,4}, {5,3}, {0,4}};
+
+    State ref = psi;
+    C Xg[2][2]; gate_X(Xg);
+    for (const auto& [c, t] : layer) apply_controlled_1q(Xg, ref, c, t);
+
+    apply_cnot_layer(psi, layer);
+    expect_state_eq(psi, ref);
+}
@@ -0,0 +1,196 @@
+// tests/mps_test.cc
+#include "mps.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace qc;
+
+namespace {
+
+void expect_state_eq(const State& psi, const State& ref, double tol = 1e-10) {
+    ASSERT_EQ(psi.size(), ref.size());
+    for (size_t i = 0; i < psi.size(); ++i) {
+        EXPECT_NEAR(psi[i].real(), ref[i].real(), tol) << "i=" << i << " (real)";
+        EXPECT_NEAR(psi[i].imag(), ref[i].imag(), tol) << "i=" << i << " (imag)";
+    }
+}
+
+double fidelity(const State& a, const State& b) {
+    C ov{0,0};
+    for (size_t i = 0; i < a.size(); ++i) ov += std::conj(a[i]) * b[i];
+    return std::norm(ov);
+}
+
+// Layered brickwork-plus-long-range circuit applied identically to both backends.
+template <class S>
+void scramble(S& psi, int n, int layers) {
+    C H[2][2]; gate_H(H);
+    C CX[4][4]; gate_CNOT(CX);
+    for (int L = 0; L < layers; ++L) {
+        for (int q = 0; q < n; ++q) {
+            C Rz[2][2]; gate_Rz(Rz, 0.3 + 0.17 * q + 0.5 * L);
+            apply_1q(H, psi, q);
+            apply_1q(Rz, psi, q);
+        }
+        for (int q = L % 2; q + 1 < n; q += 2) apply_2q(CX, psi, q, q + 1);
+        apply_2q(CX, psi, n - 1, 0);             // routed through every site
+        apply_2q(CX, psi, 1, n - 2);
+    }
+}
+
+} // namespace
+
+TEST(Mps, SvdReconstructsTallAndWide) {
+    for (auto [m, n] : {std::pair{5, 3}, std::pair{3, 5}, std::pair{4, 4}}) {
+        std::vector<C> M((size_t)m * n);
+        for (int i = 0; i < m * n; ++i) M[i] = C{std::sin(1.3 * i + 0.2), std::cos(0.7 * i * i)};
+        std::vector<C> U, Vh;
+        std::vector<double> S;
+        svd(M, m, n, U, S, Vh);
+        const int r = std::min(m, n);
+        ASSERT_EQ((int)S.size(), r);
+        for (int k = 1; k < r; ++k) EXPECT_GE(S[k - 1], S[k]);
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < n; ++j) {
+                C acc{0,0};
+                for (int k = 0; k < r; ++k) acc += U[i * r + k] * S[k] * Vh[k * n + j];
+                EXPECT_NEAR(std::abs(acc - M[i * n + j]), 0.0, 1e-12);
+            }
+        for (int a = 0; a < r; ++a)                 // U has orthonormal columns
+            for (int b = 0; b < r; ++b) {
+                C acc{0,0};
+                for (int i = 0; i < m; ++i) acc += std::conj(U[i * r + a]) * U[i * r + b];
+                EXPECT_NEAR(std::abs(acc - C{a == b ? 1.0 : 0.0, 0}), 0.0, 1e-12);
+            }
+    }
+}
+
+TEST(Mps, SvdHandlesRankDeficientUnsortedColumns) {
+    // Rank 1, column norms 1 < 3 < 2, so the norm-sorted QR preconditioner must permute.
+    const int m = 6, n = 3;
+    const double scale[n] = {1.0, 3.0, 2.0};
+    std::vector<C> M((size_t)m * n);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) M[i * n + j] = C{std::cos(0.9 * i), std::sin(0.4 * i + 1)} * scale[j];
+    std::vector<C> U, Vh;
+    std::vector<double> S;
+    svd(M, m, n, U, S, Vh);
+    ASSERT_EQ((int)S.size(), n);
+    EXPECT_NEAR(S[1], 0.0, 1e-12);
+    EXPECT_NEAR(S[2], 0.0, 1e-12);
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) {
+            C acc{0,0};
+            for (int k = 0; k < n; ++k) acc += U[i * n + k] * S[k] * Vh[k * n + j];
+            EXPECT_NEAR(std::abs(acc - M[i * n + j]), 0.0, 1e-12);
+        }
+    EXPECT_NEAR(S[0], std::sqrt(14.0) * std::sqrt([&] {
+        double c2 = 0.0;
+        for (int i = 0; i < m; ++i) c2 += std::norm(M[i * n]);
+        return c2;
+    }()), 1e-12);
+}
+
+TEST(Mps, QrReconstructsTallAndWide) {
+    for (auto [m, n] : {std::pair{5, 3}, std::pair{3, 5}, std::pair{4, 4}}) {
+        std::vector<C> M((size_t)m * n);
+        for (int i = 0; i < m * n; ++i) M[i] = C{std::cos(0.9 * i + 0.4), std::sin(0.3 * i * i)};
+        std::vector<C> Q, R;
+        qr(M, m, n, Q, R);
+        const int k = std::min(m, n);
+        ASSERT_EQ(Q.size(), (size_t)m * k);
+        ASSERT_EQ(R.size(), (size_t)k * n);
+        for (int i = 0; i < k; ++i)
+            for (int j = 0; j < i; ++j) EXPECT_EQ(R[i * n + j], C(0, 0));   // upper triangular
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < n; ++j) {
+                C acc{0,0};
+                for (int c = 0; c < k; ++c) acc += Q[i * k + c] * R[c * n + j];
+                EXPECT_NEAR(std::abs(acc - M[i * n + j]), 0.0, 1e-12);
+            }
+        for (int a = 0; a < k; ++a)                 // Q has orthonormal columns
+            for (int b = 0; b < k; ++b) {
+                C acc{0,0};
+                for (int i = 0; i < m; ++i) acc += std::conj(Q[i * k + a]) * Q[i * k + b];
+                EXPECT_NEAR(std::abs(acc - C{a == b ? 1.0 : 0.0, 0}), 0.0, 1e-12);
+            }
+    }
+}
+
+TEST(Mps, MatchesStateVectorWithoutTruncation) {
+    const int n = 6;
+    State dense = basis(n, 0b010011);
+    Mps mps(n, 0b010011, MpsConfig{/*max_bond=*/64, /*cutoff=*/0.0});
+    scramble(dense, n, 3);
+    scramble(mps, n, 3);
+    expect_state_eq(mps.to_state(), dense);
+    EXPECT_NEAR(mps.truncation_error(), 0.0, 1e-20);
+    EXPECT_LE(mps.max_bond_dim(), 8);           // 2^(n/2) at most
+    EXPECT_NEAR(std::abs(mps.amplitude(5) - dense[5]), 0.0, 1e-10);
+}
+
+TEST(Mps, ControlledGatesFollowDenseConvention) {
+    const int n = 5;
+    C X[2][2]; gate_X(X);
+    C H[2][2]; gate_H(H);
+    State dense = basis(n, 0);
+    Mps mps(n);
+    for (auto [c, t] : {std::pair{0, 3}, std::pair{4, 1}, std::pair{2, 1}}) {
+        apply_1q(H, dense, c); apply_1q(H, mps, c);
+        apply_controlled_1q(X, dense, c, t); apply_controlled_1q(X, mps, c, t);
+    }
+    expect_state_eq(mps.to_state(), dense);
+}
+
+TEST(Mps, TruncationIsReportedAndBounded) {
+    const int n = 6;
+    State dense = basis(n, 0);
+    Mps mps(n, 0, MpsConfig{/*max_bond=*/2, /*cutoff=*/0.0});
+    scramble(dense, n, 3);
+    scramble(mps, n, 3);
+    EXPECT_LE(mps.max_bond_dim(), 2);
+    EXPECT_GT(mps.truncation_error(), 0.0);
+    const State approx = mps.to_state();
+    double norm = 0.0;
+    for (const auto& a : approx) norm += std::norm(a);
+    EXPECT_NEAR(norm, 1.0, 1e-10);
+    const double F = fidelity(approx, dense);
+    EXPECT_LT(F, 1.0);
+    EXPECT_GE(F, 1.0 - mps.truncation_error());   // discarded weight bounds the infidelity
+}
+
+TEST(Mps, MeasurementCollapsesGhzAcrossLongChain) {
+    // 40 qubits: far beyond the dense State, bond dimension 2 throughout.
+    const int n = 40;
+    C H[2][2]; gate_H(H);
+    C X[2][2]; gate_X(X);
+    Mps mps(n);
+    apply_1q(H, mps, 0);
+    for (int q = 0; q + 1 < n; ++q) apply_controlled_1q(X, mps, q, q + 1);
+    EXPECT_EQ(mps.max_bond_dim(), 2);
+    EXPECT_NEAR(mps.truncation_error(), 0.0, 1e-20);
+
+    const std::uint64_t all = (1ull << n) - 1;
+    for (int s = 0; s < 8; ++s) {
+        const std::uint64_t b = sample(mps);
+        EXPECT_TRUE(b == 0 || b == all);
+    }
+    Mps m2 = mps;
+    const int first = measure_qubit_Z(m2, n - 1);
+    for (int q = 0; q < n; q += 7) EXPECT_EQ(measure_qubit_Z(m2, q), first);
+}
+
+TEST(Mps, MeasurementMatchesStateVectorProbabilities) {
+    const int n = 4;
+    C H[2][2]; gate_H(H);
+    C Rz[2][2]; gate_Rz(Rz, 0.4);
+    Mps mps(n);
+    apply_1q(H, mps, 2);
+    apply_1q(Rz, mps, 2);
+    apply_1q(H, mps, 2);          // P(q2 = 1) = sin^2(0.2)
+    int ones = 0;
+    const int trials = 2000;
+    for (int t = 0; t < trials; ++t) ones += (sample(mps) >> 2) & 1u;
+    EXPECT_NEAR((double)ones / trials, std::pow(std::sin(0.2), 2), 0.03);
+}
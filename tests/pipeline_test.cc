@@ -0,0 +1,145 @@
+// tests/pipeline_test.cc
+#include "pipeline.h"
+#include "surface_pipeline.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace qc;
+using namespace qc::surface;
+
+TEST(BoundedQueue, MultiProducerMultiConsumerDeliversEverythingOnce) {
+    BoundedQueue<int> q(8);                 // small: producers hit backpressure
+    const int producers = 4, per = 5000;
+    std::atomic<int> live{producers};
+    std::atomic<long long> sum{0};
+    std::atomic<int> count{0};
+
+    std::vector<std::thread> th;
+    for (int p = 0; p < producers; ++p)
+        th.emplace_back([&, p] {
+            for (int i = 1; i <= per; ++i) q.push(p * per + i);
+            live.fetch_sub(1, std::memory_order_release);
+        });
+    for (int c = 0; c < 3; ++c)
+        th.emplace_back([&] {
+            int v;
+            for (;;) {
+                if (q.try_pop(v)) { sum += v; ++count; continue; }
+                if (live.load(std::memory_order_acquire) != 0) { std::this_thread::yield(); continue; }
+                if (!q.try_pop(v)) break;
+                sum += v; ++count;
+            }
+        });
+    for (auto& t : th) t.join();
+
+    const long long n = (long long)producers * per;
+    EXPECT_EQ(count.load(), n);
+    EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+}
+
+TEST(BoundedQueue, BlockingPopDrainsThenStopsAfterClose) {
+    BoundedQueue<int> q(4);
+    const int producers = 3, per = 4000;
+    std::atomic<int> live{producers};
+    std::atomic<long long> sum{0};
+    std::atomic<int> count{0};
+
+    std::vector<std::thread> th;
+    for (int c = 0; c < 2; ++c)               // consumers start first and sleep on an empty queue
+        th.emplace_back([&] {
+            int v;
+            while (q.pop(v)) { sum += v; ++count; }
+        });
+    for (int p = 0; p < producers; ++p)
+        th.emplace_back([&, p] {
+            for (int i = 1; i <= per; ++i) q.push(p * per + i);
+            if (live.fetch_sub(1, std::memory_order_acq_rel) == 1) q.close();
+        });
+    for (auto& t : th) t.join();
+
+    const long long n = (long long)producers * per;
+    EXPECT_EQ(count.load(), n);
+    EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+    int v;
+    EXPECT_FALSE(q.pop(v));
+}
+
+TEST(SurfacePipeline, NoNoiseNoFailures) {
+    PipelineConfig cfg;
+    cfg.d = 3;
+    cfg.max_shots = 8;
+    cfg.batch = 2;
+    cfg.sim_threads = 2;
+    cfg.decode_threads = 2;
+    const auto r = run_pipeline(cfg);
+    EXPECT_TRUE(r.state_vector);
+    EXPECT_EQ(r.shots, 8u);
+    EXPECT_EQ(r.failures, 0u);
+}
+
+TEST(SurfacePipeline, FixedLogicalAlwaysFails) {
+    PipelineConfig cfg;
+    cfg.d = 3;
+    cfg.xs = {0, 3, 6};                     // X_L: column 0
+    cfg.max_shots = 5;
+    cfg.batch = 2;
+    const auto r = run_pipeline(cfg);
+    EXPECT_EQ(r.shots, 5u);
+    EXPECT_EQ(r.x_failures, 5u);
+    EXPECT_EQ(r.z_failures, 0u);
+}
+
+TEST(SurfacePipeline, StateVectorAndParityBackendsAgree) {
+    PipelineConfig cfg;
+    cfg.d = 3;
+    cfg.p = 0.15;
+    cfg.max_shots = 16;
+    cfg.batch = 4;
+    cfg.have_seed = true;
+    cfg.seed = 7;
+    cfg.backend = PipelineConfig::Backend::StateVector;
+    const auto sv = run_pipeline(cfg);
+    cfg.backend = PipelineConfig::Backend::Parity;
+    const auto par = run_pipeline(cfg);
+    EXPECT_EQ(sv.shots, par.shots);
+    EXPECT_EQ(sv.x_failures, par.x_failures);
+    EXPECT_EQ(sv.z_failures, par.z_failures);
+}
+
+TEST(SurfacePipeline, StopsEarlyOnTarget) {
+    PipelineConfig cfg;
+    cfg.d = 5;                              // parity backend
+    cfg.p = 0.3;
+    cfg.max_shots = 1000000;
+    cfg.batch = 16;
+    cfg.sim_threads = 2;
+    const auto r = run_pipeline(cfg, [](const PipelineResult& s) { return s.failures >= 50; });
+    EXPECT_FALSE(r.state_vector);
+    EXPECT_GE(r.failures, 50u);
+    EXPECT_LT(r.shots, 1000000u);
+}
+
+TEST(SurfacePipeline, InlineStagesMatchThreadedRun) {
+    PipelineConfig cfg;
+    cfg.d = 5;
+    cfg.p = 0.1;
+    cfg.max_shots = 2000;
+    cfg.batch = 64;
+    cfg.decode_threads = 2;
+    cfg.have_seed = true;
+    cfg.seed = 11;
+    const auto threaded = run_pipeline(cfg);   // one sim worker: the same shot stream
+    cfg.inline_stages = true;
+    const auto inl = run_pipeline(cfg);
+    EXPECT_EQ(inl.shots, 2000u);
+    EXPECT_EQ(inl.x_failures, threaded.x_failures);
+    EXPECT_EQ(inl.z_failures, threaded.z_failures);
+
+    // Inline stops right after the batch that reaches the target.
+    cfg.max_shots = 1000000;
+    const auto r = run_pipeline(cfg, [](const PipelineResult& s) { return s.failures >= 20; });
+    EXPECT_GE(r.failures, 20u);
+    EXPECT_LT(r.failures, 20u + cfg.batch);
+}
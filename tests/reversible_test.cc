@@ -0,0 +1,94 @@
+// tests/reversible_test.cc
+#include "qc.h"
+#include "reversible.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <cmath>
+
+using namespace qc;
+
+namespace {
+void expect_state_eq(const State& psi,
+                     const std::vector<C>& ref,
+                     double tol = 1e-12) {
+    ASSERT_EQ(psi.size(), ref.size());
+    for (size_t i = 0; i < psi.size(); ++i) {
+        EXPECT_NEAR(psi[i].real(), ref[i].real(), tol) << "i=" << i << " (real)";
+        EXPECT_NEAR(psi[i].imag(), ref[i].imag(), tol) << "i=" << i << " (imag)";
+    }
+}
+
+State random_state(int n) {
+    State psi(1u << n);
+    for (size_t i = 0; i < psi.size(); ++i)
+        psi[i] = C{std::cos(0.37 * i + 0.2), std::sin(1.3 * i)};
+    renormalize(psi);
+    return psi;
+}
+
+// reference Toffoli: flip t when both controls are 1
+void toffoli_ref(State& psi, int c0, int c1, int t) {
+    for (size_t i = 0; i < psi.size(); ++i)
+        if (((i >> c0) & 1) && ((i >> c1) & 1) && !((i >> t) & 1))
+            std::swap(psi[i], psi[i | (1ull << t)]);
+}
+} // namespace
+
+TEST(Reversible, PermutationsMatchGateByGate) {
+    const int n = 5;
+    State psi = random_state(n);
+    State ref = psi;
+
+    C Xg[2][2]; gate_X(Xg);
+    C U4[4][4]; gate_CNOT(U4);
+
+    ReversibleBatch b;
+    b.x(3).cnot(0, 2).swap(1, 4).toffoli(2, 4, 0).cnot(4, 3);
+
+    apply_1q(Xg, ref, 3);
+    apply_controlled_1q(Xg, ref, 0, 2);
+    apply_controlled_1q(Xg, ref, 1, 4);   // SWAP = 3 CNOTs
+    apply_controlled_1q(Xg, ref, 4, 1);
+    apply_controlled_1q(Xg, ref, 1, 4);
+    toffoli_ref(ref, 2, 4, 0);
+    apply_controlled_1q(Xg, ref, 4, 3);
+
+    apply_reversible(b, psi);
+    expect_state_eq(psi, ref);
+}
+
+TEST(Reversible, FusedPhasesFollowPermutedBits) {
+    const int n = 4;
+    State psi = random_state(n);
+    State ref = psi;
+
+    C Xg[2][2]; gate_X(Xg);
+    C Zs[2][2] = {{C{1,0}, C{0,0}}, {C{0,0}, C{-1,0}}};
+    C Pg[2][2] = {{C{1,0}, C{0,0}}, {C{0,0}, std::polar(1.0, 0.3)}};
+
+    ReversibleBatch b;
+    b.z(0).cnot(0, 1).cz(1, 2).x(2).phase(2, 0.3);
+
+    apply_1q(Zs, ref, 0);
+    apply_controlled_1q(Xg, ref, 0, 1);
+    apply_controlled_1q(Zs, ref, 1, 2);
+    apply_1q(Xg, ref, 2);
+    apply_1q(Pg, ref, 2);
+
+    State in_place = psi;
+    State scratch;
+    apply_reversible(b, psi, scratch);
+    expect_state_eq(psi, ref);
+    apply_reversible(b, in_place);
+    expect_state_eq(in_place, ref);
+}
+
+TEST(Reversible, InPlaceHandlesChangingSizes) {
+    ReversibleBatch b;
+    b.x(0).cnot(0, 1);
+    for (int n : {5, 3, 5}) {
+        State psi = basis(n, 0);
+        apply_reversible(b, psi);
+        expect_state_eq(psi, basis(n, 0b11));
+    }
+}
@@ -0,0 +1,49 @@
+// tests/stats_test.cc
+#include "qc.h"
+#include "stats.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace qc;
+
+TEST(Stats, CountsCallsAndAmplitudes) {
+#ifndef QC_STATS
+    GTEST_SKIP() << "instrumentation compiled out";
+#endif
+    stats::reset();
+    stats::set_enabled(true);
+    State psi = basis(4, 0);
+    C H[2][2]; gate_H(H);
+    apply_1q(H, psi, 0);
+    apply_1q(H, psi, 3);
+    stats::set_enabled(false);
+    apply_1q(H, psi, 1);                    // not counted
+
+    auto& c = stats::counter("apply_1q");
+    EXPECT_EQ(c.calls.load(), 2u);
+    EXPECT_EQ(c.amps.load(), 32u);
+}
+
+TEST(Stats, ChromeTraceHasOneEventPerScope) {
+#ifndef QC_STATS
+    GTEST_SKIP() << "instrumentation compiled out";
+#endif
+    stats::reset();
+    stats::set_tracing(true);
+    State psi = basis(3, 0);
+    C X[2][2]; gate_X(X);
+    apply_1q(X, psi, 2);
+    stats::set_tracing(false);
+    stats::set_enabled(false);
+
+    const std::string path = ::testing::TempDir() + "qc_stats_trace.json";
+    ASSERT_TRUE(stats::write_chrome_trace(path));
+    std::ifstream ifs(path);
+    std::string json((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"apply_1q\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"basis\""), std::string::npos);
+    std::remove(path.c_str());
+}
@@ -86,3 +86,80 @@ TEST(SurfaceD3, YErrorAtCenter_Both11) {
     dump_syn("Y@center", z, x);
 }
 
+
+// ---------- rotated layout ----------
+namespace {
+int overlap(const std::vector<int>& a, const std::vector<int>& b) {
+    int n = 0;
+    for (int x : a) for (int y : b) n += (x == y);
+    return n;
+}
+} // namespace
+
+TEST(SurfaceRotated, LayoutCountsAndWeights) {
+    for (int d : {3, 5, 7}) {
+        auto sc = build_rotated_surface_code(d);
+        EXPECT_EQ(sc.n_qubits(), 2*d*d - 1) << "d=" << d;
+        EXPECT_EQ(sc.z_checks.size(), sc.x_checks.size());
+        int w2 = 0, w4 = 0;
+        for (const auto* checks : {&sc.z_checks, &sc.x_checks})
+            for (const auto& c : *checks) { w2 += (c.size() == 2); w4 += (c.size() == 4); }
+        EXPECT_EQ(w4, (d-1)*(d-1));
+        EXPECT_EQ(w2, 2*(d-1));
+    }
+}
+
+TEST(SurfaceRotated, ChecksCommuteAndLogicalsAnticommute) {
+    auto sc = build_rotated_surface_code(5);
+    for (const auto& zc : sc.z_checks)
+        for (const auto& xc : sc.x_checks)
+            EXPECT_EQ(overlap(zc, xc) % 2, 0);
+    for (const auto& xc : sc.x_checks) EXPECT_EQ(overlap(sc.logical_z, xc) % 2, 0);
+    for (const auto& zc : sc.z_checks) EXPECT_EQ(overlap(sc.logical_x, zc) % 2, 0);
+    EXPECT_EQ(overlap(sc.logical_x, sc.logical_z) % 2, 1);
+}
+
+TEST(SurfaceRotated, D3_NoError_AllZero) {
+    auto sc = build_rotated_surface_code(3);
+    State psiZ = basis(sc.n_qubits(), 0);
+    EXPECT_EQ(z_round(psiZ, sc), (std::vector<int>({0,0,0,0})));
+
+    State psiX = basis(sc.n_qubits(), 0);
+    prepare_all_plus_unitary(psiX, sc);
+    EXPECT_EQ(x_round(psiX, sc), (std::vector<int>({0,0,0,0})));
+}
+
+TEST(SurfaceRotated, D3_SingleErrorsMatchCheckSupport) {
+    auto sc = build_rotated_surface_code(3);
+    C Xg[2][2]; gate_X(Xg);
+    C Zg[2][2]; gate_Rz(Zg, std::numbers::pi);
+    for (int q = 0; q < sc.n_data; ++q) {
+        std::vector<int> ez, ex;
+        for (const auto& c : sc.z_checks) ez.push_back(overlap(c, {q}));
+        for (const auto& c : sc.x_checks) ex.push_back(overlap(c, {q}));
+
+        State psiZ = basis(sc.n_qubits(), 0);
+        apply_1q(Xg, psiZ, q);
+        EXPECT_EQ(z_round(psiZ, sc), ez) << "X@" << q;
+
+        State psiX = basis(sc.n_qubits(), 0);
+        prepare_all_plus_unitary(psiX, sc);
+        apply_1q(Zg, psiX, q);
+        EXPECT_EQ(x_round(psiX, sc), ex) << "Z@" << q;
+    }
+}
+
+TEST(SurfaceRotated, ScheduleLayersAreDisjointAndCoverChecks) {
+    auto sc = build_rotated_surface_code(5);
+    for (const auto* layers : {&sc.z_layers, &sc.x_layers}) {
+        ASSERT_EQ(layers->size(), 4u);
+        size_t total = 0;
+        for (const auto& layer : *layers) {
+            std::vector<int> used(sc.n_qubits(), 0);
+            for (const auto& [c, t] : layer) { ++used[c]; ++used[t]; }
+            for (int u : used) EXPECT_LE(u, 1);
+            total += layer.size();
+        }
+        EXPECT_EQ(total, (size_t)(2*(sc.d-1)*(sc.d-1) + 2*(sc.d-1)));
+    }
+}
@@ -0,0 +1,66 @@
+// tests/sweep_test.cc
+#include "sweep.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using namespace qc::surface;
+
+TEST(Sweep, WilsonIntervalBracketsEstimate) {
+    double lo, hi;
+    wilson_interval(50, 1000, 1.96, lo, hi);
+    EXPECT_LT(lo, 0.05);
+    EXPECT_GT(hi, 0.05);
+    EXPECT_NEAR(lo, 0.0381, 1e-3);
+    EXPECT_NEAR(hi, 0.0653, 1e-3);
+
+    wilson_interval(0, 100, 1.96, lo, hi);
+    EXPECT_EQ(lo, 0.0);
+    EXPECT_GT(hi, 0.0);
+}
+
+TEST(Sweep, PointsStopOnTargetFailures) {
+    SweepConfig cfg;
+    cfg.ds = {5, 7};
+    cfg.ps = {0.15, 0.25};
+    cfg.max_shots = 1000000;
+    cfg.target_failures = 30;
+    cfg.batch = 32;
+    cfg.threads = 2;
+    cfg.have_seed = true;
+    cfg.seed = 3;
+    const auto pts = run_sweep(cfg);
+
+    ASSERT_EQ(pts.size(), 4u);
+    EXPECT_EQ(pts[0].d, 5); EXPECT_EQ(pts[0].p, 0.15);
+    EXPECT_EQ(pts[3].d, 7); EXPECT_EQ(pts[3].p, 0.25);
+    for (const auto& pt : pts) {
+        EXPECT_STREQ(pt.stop, "failures");
+        EXPECT_GE(pt.r.failures, 30u);
+        EXPECT_LT(pt.r.shots, cfg.max_shots);
+        EXPECT_LE(pt.ci_lo, pt.p_L);
+        EXPECT_GE(pt.ci_hi, pt.p_L);
+    }
+}
+
+TEST(Sweep, MaxShotsCapsUnconvergedPoints) {
+    SweepConfig cfg;
+    cfg.ds = {5};
+    cfg.ps = {0.0};
+    cfg.max_shots = 500;
+    cfg.target_failures = 10;
+    cfg.target_rel_ci = 0.1;
+    cfg.batch = 100;
+    const auto pts = run_sweep(cfg);
+    ASSERT_EQ(pts.size(), 1u);
+    EXPECT_EQ(pts[0].r.shots, 500u);
+    EXPECT_EQ(pts[0].r.failures, 0u);
+    EXPECT_STREQ(pts[0].stop, "max_shots");
+
+    std::ostringstream csv, json;
+    write_sweep_csv(csv, pts);
+    write_sweep_json(json, pts);
+    EXPECT_EQ(csv.str().rfind("d,p,shots,failures,", 0), 0u);
+    EXPECT_NE(csv.str().find("\n5,0,500,0,"), std::string::npos);
+    EXPECT_NE(json.str().find("\"stop\":\"max_shots\""), std::string::npos);
+}
@@ -0,0 +1,97 @@
+// tests/utils_test.cc
+#include "qc.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace qc;
+
+namespace {
+// capture std::cout of pretty_print
+std::string print_to_string(const State& psi, int n, int max_terms, double cutoff) {
+    std::ostringstream oss;
+    auto* old = std::cout.rdbuf(oss.rdbuf());
+    pretty_print(psi, n, max_terms, cutoff, /*precision=*/4, /*show_prob=*/true, /*show_phase=*/false);
+    std::cout.rdbuf(old);
+    return oss.str();
+}
+
+std::vector<std::string> kets(const std::string& out) {
+    std::vector<std::string> ks;
+    std::istringstream iss(out);
+    std::string line;
+    while (std::getline(iss, line)) {
+        const auto a = line.find("  |");
+        if (a != 0) continue;
+        ks.push_back(line.substr(3, line.find('>') - 3));
+    }
+    return ks;
+}
+} // namespace
+
+TEST(PrettyPrint, TopKIsSortedByProbability) {
+    const int n = 18;                        // large enough to split across workers
+    State psi(1u << n, C{1e-4, 0});
+    psi[5]      = C{0.5, 0};
+    psi[70000]  = C{0, -0.7};
+    psi[262143] = C{0.3, 0.1};
+
+    const auto ks = kets(print_to_string(psi, n, /*max_terms=*/3, /*cutoff=*/1e-12));
+    ASSERT_EQ(ks.size(), 3u);
+    EXPECT_EQ(ks[0], "010001000101110000");  // 70000
+    EXPECT_EQ(ks[1], "000000000000000101");  // 5
+    EXPECT_EQ(ks[2], "111111111111111111");  // 262143
+}
+
+TEST(PrettyPrint, CutoffWithoutLimitListsAllTerms) {
+    State psi = basis(3, 0);
+    C H[2][2]; gate_H(H);
+    apply_1q(H, psi, 0);
+    apply_1q(H, psi, 2);
+    const auto ks = kets(print_to_string(psi, 3, /*max_terms=*/0, /*cutoff=*/1e-9));
+    EXPECT_EQ(ks, (std::vector<std::string>{"000", "001", "100", "101"}));
+}
+
+TEST(PrettyPrint, CutoffIsRelativeToTheNorm) {
+    // Unnormalized, with the small term scanned before the sum that rules it out.
+    const State psi = {C{0.002, 0}, C{0, 0}, C{0, 0}, C{2, 0}};
+    const auto ks = kets(print_to_string(psi, 2, /*max_terms=*/0, /*cutoff=*/1e-5));
+    EXPECT_EQ(ks, (std::vector<std::string>{"11"}));
+}
+
+TEST(ExportProbabilities, WritesNormalizedDoubles) {
+    State psi = {C{1,0}, C{0,1}, C{0,0}, C{-1,1}};   // unnormalized, Σ|a|² = 4
+    const std::string path = ::testing::TempDir() + "qc_probs.bin";
+    export_probabilities(psi, path);
+
+    std::ifstream ifs(path, std::ios::binary);
+    std::vector<double> p(4);
+    ifs.read(reinterpret_cast<char*>(p.data()), 4 * sizeof(double));
+    ASSERT_TRUE(ifs);
+    EXPECT_DOUBLE_EQ(p[0], 0.25);
+    EXPECT_DOUBLE_EQ(p[1], 0.25);
+    EXPECT_DOUBLE_EQ(p[2], 0.0);
+    EXPECT_DOUBLE_EQ(p[3], 0.5);
+    std::remove(path.c_str());
+}
+
+TEST(ExportProbabilities, NormalizedStateInOnePass) {
+    State psi = basis(3, 0);
+    C H[2][2]; gate_H(H);
+    apply_1q(H, psi, 0);
+    apply_1q(H, psi, 1);
+    const std::string path = ::testing::TempDir() + "qc_probs_norm.bin";
+    export_probabilities(psi, path);
+
+    std::ifstream ifs(path, std::ios::binary);
+    std::vector<double> p(8);
+    ifs.read(reinterpret_cast<char*>(p.data()), 8 * sizeof(double));
+    ASSERT_TRUE(ifs);
+    for (int i = 0; i < 4; ++i) EXPECT_DOUBLE_EQ(p[i], 0.25) << "i=" << i;
+    for (int i = 4; i < 8; ++i) EXPECT_EQ(p[i], 0.0) << "i=" << i;
+    std::remove(path.c_str());
+}